@@ -0,0 +1,460 @@
+#pragma once
+
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <bit>
+#include <array>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <concepts>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+
+#include "internal/dev_env.hpp"
+#include "internal/types.hpp"
+
+#include "numeric/modular/modint_interface.hpp"
+
+
+namespace uni {
+
+namespace internal {
+
+
+template<class T>
+concept readable_integer =
+    (std::integral<T> && !std::same_as<T, bool> && !std::same_as<T, char>) ||
+    std::same_as<T, int128_t> || std::same_as<T, uint128_t>;
+
+
+// Folds decimal digits, fed in chunks of at most `CHUNK_DIGITS`, into a modint.
+// Values below 10^18 cost a single conversion into the reduced form; longer ones one multiplication per further chunk.
+template<modint_family T>
+struct modint_builder {
+    static constexpr int CHUNK_DIGITS = 18;
+
+    static constexpr auto POWERS = [] {
+        std::array<std::uint64_t, CHUNK_DIGITS + 1> res{ 1 };
+        for(int i = 1; i <= CHUNK_DIGITS; ++i) res[i] = res[i - 1] * 10;
+        return res;
+    }();
+
+    T value = T::zero;
+    bool empty = true;
+
+    inline void push(const std::uint64_t chunk, const int digits) noexcept(NO_EXCEPT) {
+        if(this->empty) this->value = T(chunk), this->empty = false;
+        else this->value = this->value * T(POWERS[digits]) + T(chunk);
+    }
+
+    // Feeds the digits of `str`, an optionally signed decimal; returns `false` if it is malformed.
+    bool push(std::string_view str) noexcept(NO_EXCEPT) {
+        bool negative = false;
+        if(!str.empty() && (str.front() == '-' || str.front() == '+')) {
+            negative = str.front() == '-';
+            str.remove_prefix(1);
+        }
+
+        if(str.empty()) return false;
+
+        std::uint64_t chunk = 0;
+        int digits = 0;
+
+        for(const char c : str) {
+            if(static_cast<unsigned char>(c - '0') >= 10) return false;
+
+            chunk = chunk * 10 + static_cast<std::uint64_t>(c - '0');
+            if(++digits == CHUNK_DIGITS) this->push(chunk, digits), chunk = 0, digits = 0;
+        }
+        if(digits > 0) this->push(chunk, digits);
+
+        if(negative) this->value = -this->value;
+        return true;
+    }
+};
+
+
+} // namespace internal
+
+
+// A whitespace-separated token scanner over a file descriptor, for use as `input_adaptor<fast_reader>`.
+// Regular files are mapped at once; pipes and terminals are read through a buffer, one `read` per refill.
+// It does not share its position with `std::cin`, so the two should not be mixed on the same input.
+// Reading `std::string_view`s keeps the whole input resident, so that they never dangle nor copy.
+struct fast_reader {
+    using char_type = char;
+
+    static constexpr std::size_t BUFFER_SIZE = 1 << 17;
+
+  private:
+    int _fd;
+
+    const char *_cur = nullptr, *_end = nullptr;
+
+    std::unique_ptr<char[]> _buffer;
+
+    void *_mapped = nullptr;
+    std::size_t _mapped_size = 0;
+
+    bool _eof = false, _fail = false;
+
+    // The rest of a non-mappable input, once `string_view`s are requested.
+    std::string _resident;
+
+    std::string _token;
+
+    inline static constexpr bool _is_space(const char c) noexcept {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    // Returns whether new input arrived.
+    bool _refill() noexcept(NO_EXCEPT) {
+        if(this->_eof) return false;
+
+        ssize_t size;
+        do size = ::read(this->_fd, this->_buffer.get(), BUFFER_SIZE);
+        while(size < 0 && errno == EINTR);
+
+        if(size <= 0) {
+            this->_eof = true;
+            return false;
+        }
+
+        this->_cur = this->_buffer.get();
+        this->_end = this->_cur + size;
+        return true;
+    }
+
+    // Makes the rest of the input stay in memory until the reader is destroyed; mapped inputs already do.
+    void _hold() noexcept(NO_EXCEPT) {
+        if(this->_eof) return;
+
+        this->_resident.assign(this->_cur, this->_end);
+        while(this->_refill()) this->_resident.append(this->_cur, this->_end);
+
+        this->_cur = this->_resident.data();
+        this->_end = this->_cur + this->_resident.size();
+    }
+
+    bool _skip_spaces() noexcept(NO_EXCEPT) {
+        while(true) {
+            while(this->_cur < this->_end && _is_space(*this->_cur)) ++this->_cur;
+            if(this->_cur < this->_end) return true;
+            if(!this->_refill()) return false;
+        }
+    }
+
+    // Appends the characters up to the next whitespace to `res`.
+    void _append_token(std::string& res) noexcept(NO_EXCEPT) {
+        while(true) {
+            const char* p = this->_cur;
+            while(p < this->_end && !_is_space(*p)) ++p;
+
+            res.append(this->_cur, p);
+            this->_cur = p;
+
+            if(this->_cur < this->_end || !this->_refill()) return;
+        }
+    }
+
+    template<internal::readable_integer T>
+    void _read_integer(T& val) noexcept(NO_EXCEPT) {
+        if(!this->_skip_spaces()) {
+            this->_fail = true;
+            return;
+        }
+
+        bool negative = false;
+        if(*this->_cur == '-' || *this->_cur == '+') {
+            negative = *this->_cur++ == '-';
+            if(this->_cur == this->_end) this->_refill();
+        }
+
+        using unsigned_type = std::conditional_t<(sizeof(T) > sizeof(std::uint64_t)), internal::uint128_t, std::make_unsigned_t<T>>;
+
+        unsigned_type res = 0;
+        bool digits = false;
+
+        // Digits are accumulated across refills, so tokens need not fit in the buffer.
+        while(true) {
+            const char* p = this->_cur;
+            while(p < this->_end && static_cast<unsigned char>(*p - '0') < 10) {
+                res = res * 10 + static_cast<unsigned_type>(*p++ - '0');
+            }
+
+            digits |= p != this->_cur;
+            this->_cur = p;
+
+            if(this->_cur < this->_end || !this->_refill()) break;
+        }
+
+        if(!digits) this->_fail = true;
+
+        val = static_cast<T>(negative ? -res : res);
+    }
+
+    template<internal::modint_family T>
+    void _read_modint(T& val) noexcept(NO_EXCEPT) {
+        if(!this->_skip_spaces()) {
+            this->_fail = true;
+            return;
+        }
+
+        bool negative = false;
+        if(*this->_cur == '-' || *this->_cur == '+') {
+            negative = *this->_cur++ == '-';
+            if(this->_cur == this->_end) this->_refill();
+        }
+
+        using builder = internal::modint_builder<T>;
+        builder res;
+
+        std::uint64_t chunk = 0;
+        int digits = 0;
+
+        while(true) {
+            const char* p = this->_cur;
+            while(p < this->_end && static_cast<unsigned char>(*p - '0') < 10) {
+                chunk = chunk * 10 + static_cast<std::uint64_t>(*p++ - '0');
+                if(++digits == builder::CHUNK_DIGITS) res.push(chunk, digits), chunk = 0, digits = 0;
+            }
+
+            this->_cur = p;
+
+            if(this->_cur < this->_end || !this->_refill()) break;
+        }
+
+        if(digits > 0) res.push(chunk, digits);
+        if(res.empty) this->_fail = true;
+
+        val = negative ? -res.value : res.value;
+    }
+
+#if defined(__x86_64__) || defined(__i386__)
+
+    // Parses a token of up to 16 digits at once: the delimiter is located with one comparison of 16 bytes,
+    // and the digits are combined pairwise by multiply-adds into two 8-digit halves.
+    // Tokens near the end of the available input, and longer or malformed ones, are left to `_read_integer`.
+    template<std::integral T>
+    __attribute__((target("sse4.1")))
+    void _read_integers(T* first, T* const last) noexcept(NO_EXCEPT) {
+        alignas(16) static constexpr std::int8_t SHIFT[32] = {
+            -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128, -128,
+            0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15
+        };
+
+        const __m128i zero = _mm_set1_epi8('0'), nine = _mm_set1_epi8(9);
+        const __m128i mul_10 = _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1);
+        const __m128i mul_100 = _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1);
+        const __m128i mul_10000 = _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1);
+
+        for(; first != last; ++first) {
+            const char* p = this->_cur;
+            while(p < this->_end && _is_space(*p)) ++p;
+
+            if(this->_end - p <= 16) {
+                this->_cur = p;
+                this->_read_integer(*first);
+                continue;
+            }
+
+            const char* const token = p;
+
+            bool negative = false;
+            if(*p == '-' || *p == '+') negative = *p++ == '-';
+
+            __m128i digits = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), zero);
+
+            const auto mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(digits, nine), digits)));
+            const int length = std::countr_zero(~mask);
+
+            if(length == 0 || length == 16) {
+                this->_cur = token;
+                this->_read_integer(*first);
+                continue;
+            }
+
+            // Right-align the digits, clearing the bytes in front of them.
+            digits = _mm_shuffle_epi8(digits, _mm_loadu_si128(reinterpret_cast<const __m128i*>(SHIFT + length)));
+
+            digits = _mm_maddubs_epi16(digits, mul_10);
+            digits = _mm_madd_epi16(digits, mul_100);
+            digits = _mm_packus_epi32(digits, digits);
+            digits = _mm_madd_epi16(digits, mul_10000);
+
+            const auto high = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_cvtsi128_si32(digits)));
+            const auto low = static_cast<std::uint64_t>(static_cast<std::uint32_t>(_mm_extract_epi32(digits, 1)));
+            const std::uint64_t res = high * 100000000 + low;
+
+            *first = static_cast<T>(negative ? -res : res);
+            this->_cur = p + length;
+        }
+    }
+
+    // `_read_integers` is compiled for SSE4.1 whatever the target is, so it runs only where the CPU turns out to support it.
+    inline static bool _has_sse4_1() noexcept {
+#ifdef __SSE4_1__
+        return true;
+#else
+        static const bool res = (__builtin_cpu_init(), __builtin_cpu_supports("sse4.1"));
+        return res;
+#endif
+    }
+
+#endif
+
+  public:
+    explicit fast_reader(const int fd = 0) noexcept(NO_EXCEPT) : _fd(fd) {
+        struct stat st;
+
+        if(::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            this->_mapped_size = static_cast<std::size_t>(st.st_size);
+            this->_mapped = ::mmap(nullptr, this->_mapped_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+            if(this->_mapped != MAP_FAILED) {
+                ::madvise(this->_mapped, this->_mapped_size, MADV_SEQUENTIAL);
+
+                this->_cur = static_cast<const char*>(this->_mapped);
+                this->_end = this->_cur + this->_mapped_size;
+                this->_eof = true;
+                return;
+            }
+
+            this->_mapped = nullptr;
+        }
+
+        this->_buffer.reset(new char[BUFFER_SIZE]);
+    }
+
+    fast_reader(const fast_reader&) = delete;
+    fast_reader& operator=(const fast_reader&) = delete;
+
+    ~fast_reader() {
+        if(this->_mapped) ::munmap(this->_mapped, this->_mapped_size);
+    }
+
+    // The reader of the standard input.
+    inline static fast_reader& standard() noexcept(NO_EXCEPT) {
+        static fast_reader reader(STDIN_FILENO);
+        return reader;
+    }
+
+
+    template<internal::readable_integer T>
+    inline fast_reader& operator>>(T& val) noexcept(NO_EXCEPT) {
+        this->_read_integer(val);
+        return *this;
+    }
+
+    // Reads `size` integers into `data`, several bytes at a time where the instruction set allows.
+    template<internal::readable_integer T>
+    fast_reader& read(T* const data, const std::size_t size) noexcept(NO_EXCEPT) {
+#if defined(__x86_64__) || defined(__i386__)
+        if constexpr(std::integral<T>) {
+            if(_has_sse4_1()) {
+                this->_read_integers(data, data + size);
+                return *this;
+            }
+        }
+#endif
+        for(std::size_t i = 0; i < size; ++i) this->_read_integer(data[i]);
+        return *this;
+    }
+
+
+    // Parsed straight into the reduced form, so that values beyond 64 bits are accepted as well.
+    template<internal::modint_family T>
+    inline fast_reader& operator>>(T& val) noexcept(NO_EXCEPT) {
+        this->_read_modint(val);
+        return *this;
+    }
+
+    inline fast_reader& operator>>(bool& val) noexcept(NO_EXCEPT) {
+        int v = 0; this->_read_integer(v);
+        val = v;
+        return *this;
+    }
+
+    inline fast_reader& operator>>(char& val) noexcept(NO_EXCEPT) {
+        if(!this->_skip_spaces()) this->_fail = true;
+        else val = *this->_cur++;
+        return *this;
+    }
+
+    inline fast_reader& operator>>(std::string& val) noexcept(NO_EXCEPT) {
+        val.clear();
+        if(!this->_skip_spaces()) this->_fail = true;
+        else this->_append_token(val);
+        return *this;
+    }
+
+    // Views into the input itself, valid as long as the reader is (i.e. for the program lifetime with `standard()`).
+    inline fast_reader& operator>>(std::string_view& val) noexcept(NO_EXCEPT) {
+        this->_hold();
+
+        if(!this->_skip_spaces()) {
+            this->_fail = true;
+            return *this;
+        }
+
+        const char* p = this->_cur;
+        while(p < this->_end && !_is_space(*p)) ++p;
+
+        val = { this->_cur, p };
+        this->_cur = p;
+        return *this;
+    }
+
+    // Reads the rest of the current line without its terminator (`\n` or `\r\n`), as a view into the input.
+    fast_reader& getline(std::string_view& val) noexcept(NO_EXCEPT) {
+        this->_hold();
+
+        if(this->_cur == this->_end) {
+            this->_fail = true;
+            return *this;
+        }
+
+        const char* p = static_cast<const char*>(std::memchr(this->_cur, '\n', static_cast<std::size_t>(this->_end - this->_cur)));
+        const char* const next = p ? p + 1 : this->_end;
+        if(!p) p = this->_end;
+
+        if(p > this->_cur && *(p - 1) == '\r') --p;
+
+        val = { this->_cur, p };
+        this->_cur = next;
+        return *this;
+    }
+
+    template<std::floating_point T>
+    inline fast_reader& operator>>(T& val) noexcept(NO_EXCEPT) {
+        *this >> this->_token;
+
+        if(!this->_fail) {
+            const auto first = this->_token.data(), last = first + this->_token.size();
+            const auto [ ptr, error ] = std::from_chars(first + (*first == '+'), last, val);
+            if(error != std::errc{} || ptr != last) this->_fail = true;
+        }
+
+        return *this;
+    }
+
+
+    explicit operator bool() const noexcept { return !this->_fail; }
+};
+
+
+} // namespace uni
@@ -0,0 +1,225 @@
+#pragma once
+
+
+#include <cstdio>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <array>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <concepts>
+#include <type_traits>
+#include <algorithm>
+
+
+#include "internal/dev_env.hpp"
+#include "internal/types.hpp"
+
+
+namespace uni {
+
+namespace internal {
+
+
+template<class T>
+concept writable_integer =
+    (std::integral<T> && !std::same_as<T, bool> && !std::same_as<T, char> && !std::same_as<T, signed char> && !std::same_as<T, unsigned char>) ||
+    std::same_as<T, int128_t> || std::same_as<T, uint128_t>;
+
+
+} // namespace internal
+
+
+// Accumulates output in a large buffer, and hands it to `FILE*` with a single `fwrite` per flush.
+// For use as `output_adaptor<fast_writer>`; numbers are written with `std::to_chars`.
+struct fast_writer {
+    using char_type = char;
+    using off_type = std::streamoff;
+
+    static constexpr std::size_t BUFFER_SIZE = 1 << 16;
+
+    // Enough for any number: 128-bit integers, and `long double` in fixed notation with 20 decimal places.
+    static constexpr std::size_t NUMBER_SIZE = std::numeric_limits<long double>::max_exponent10 + 64;
+
+  private:
+    std::FILE* _file;
+
+    std::array<char, BUFFER_SIZE> _buffer;
+    std::size_t _size = 0;
+
+    // Receives the stream manipulators (`std::fixed`, `std::setprecision`, ...) to know how to format floating-point values.
+    std::ostringstream _format;
+
+    inline void _reserve(const std::size_t size) noexcept(NO_EXCEPT) {
+        if(this->_size + size > BUFFER_SIZE) this->flush();
+    }
+
+    template<internal::writable_integer T>
+    void _write_integer(T val) noexcept(NO_EXCEPT) {
+        this->_reserve(NUMBER_SIZE);
+
+        char* first = this->_buffer.data() + this->_size;
+
+        if constexpr(std::same_as<T, internal::int128_t> || std::same_as<T, internal::uint128_t>) {
+            internal::uint128_t abs = static_cast<internal::uint128_t>(val);
+            if constexpr(std::is_signed_v<T>) {
+                if(val < 0) *first++ = '-', abs = -abs;
+            }
+
+            std::array<char, 40> digits;
+            auto p = digits.end();
+            do *--p = static_cast<char>('0' + static_cast<int>(abs % 10)), abs /= 10; while(abs > 0);
+
+            first = std::copy(p, digits.end(), first);
+        }
+        else {
+            first = std::to_chars(first, this->_buffer.data() + BUFFER_SIZE, val).ptr;
+        }
+
+        this->_size = static_cast<std::size_t>(first - this->_buffer.data());
+    }
+
+    template<std::floating_point T>
+    void _write_floating_point(const T val) noexcept(NO_EXCEPT) {
+        const auto flags = this->_format.flags() & std::ios_base::floatfield;
+        const auto precision = static_cast<int>(this->_format.precision());
+
+        std::to_chars_result res;
+        const auto write = [&](const std::size_t size) {
+            char* const first = this->_buffer.data() + this->_size;
+            if(flags == std::ios_base::fixed) res = std::to_chars(first, first + size, val, std::chars_format::fixed, precision);
+            else if(flags == std::ios_base::scientific) res = std::to_chars(first, first + size, val, std::chars_format::scientific, precision);
+            else res = std::to_chars(first, first + size, val, std::chars_format::general, precision);
+        };
+
+        this->_reserve(NUMBER_SIZE);
+        write(BUFFER_SIZE - this->_size);
+
+        // Only an unusual precision can overflow; fall back to the stream then.
+        if(res.ec != std::errc{}) {
+            std::ostringstream out;
+            out.copyfmt(this->_format);
+            out << val;
+            this->write(out.view());
+            return;
+        }
+
+        this->_size = static_cast<std::size_t>(res.ptr - this->_buffer.data());
+    }
+
+  public:
+    explicit fast_writer(std::FILE* const file = stdout) noexcept(NO_EXCEPT) : _file(file) {
+        this->_format.precision(6);
+    }
+
+    fast_writer(const fast_writer&) = delete;
+    fast_writer& operator=(const fast_writer&) = delete;
+
+    ~fast_writer() { this->flush(); }
+
+    // The writer of the standard output.
+    inline static fast_writer& standard() noexcept(NO_EXCEPT) {
+        static fast_writer writer(stdout);
+        return writer;
+    }
+
+
+    inline fast_writer& put(const char c) noexcept(NO_EXCEPT) {
+        if(this->_size == BUFFER_SIZE) this->flush();
+        this->_buffer[this->_size++] = c;
+        return *this;
+    }
+
+    inline fast_writer& write(std::string_view str) noexcept(NO_EXCEPT) {
+        while(!str.empty()) {
+            if(this->_size == BUFFER_SIZE) this->flush();
+
+            const auto size = std::min(str.size(), BUFFER_SIZE - this->_size);
+            std::memcpy(this->_buffer.data() + this->_size, str.data(), size);
+            this->_size += size;
+
+            str.remove_prefix(size);
+        }
+        return *this;
+    }
+
+    inline fast_writer& flush() noexcept(NO_EXCEPT) {
+        if(this->_size > 0) std::fwrite(this->_buffer.data(), 1, this->_size, this->_file);
+        this->_size = 0;
+        std::fflush(this->_file);
+        return *this;
+    }
+
+    // Only moves within the pending output, e.g. `seekp(-1)` to drop a trailing separator.
+    inline fast_writer& seekp(const off_type off, const std::ios_base::seekdir dir = std::ios_base::cur) noexcept(NO_EXCEPT) {
+        const auto base = static_cast<off_type>(dir == std::ios_base::cur ? this->_size : 0);
+        this->_size = static_cast<std::size_t>(std::clamp<off_type>(base + off, 0, static_cast<off_type>(this->_size)));
+        return *this;
+    }
+
+
+    template<internal::writable_integer T>
+    inline fast_writer& operator<<(const T val) noexcept(NO_EXCEPT) {
+        this->_write_integer(val);
+        return *this;
+    }
+
+    template<std::floating_point T>
+    inline fast_writer& operator<<(const T val) noexcept(NO_EXCEPT) {
+        this->_write_floating_point(val);
+        return *this;
+    }
+
+    inline fast_writer& operator<<(const bool val) noexcept(NO_EXCEPT) { return this->put(val ? '1' : '0'); }
+
+    inline fast_writer& operator<<(const char val) noexcept(NO_EXCEPT) { return this->put(val); }
+    inline fast_writer& operator<<(const signed char val) noexcept(NO_EXCEPT) { return this->put(static_cast<char>(val)); }
+    inline fast_writer& operator<<(const unsigned char val) noexcept(NO_EXCEPT) { return this->put(static_cast<char>(val)); }
+
+    inline fast_writer& operator<<(const char* const val) noexcept(NO_EXCEPT) { return this->write(val); }
+    inline fast_writer& operator<<(const std::string_view val) noexcept(NO_EXCEPT) { return this->write(val); }
+    inline fast_writer& operator<<(const std::string& val) noexcept(NO_EXCEPT) { return this->write(val); }
+
+    // `std::endl` and `std::flush`.
+    inline fast_writer& operator<<(std::ostream& (*const manipulator)(std::ostream&)) noexcept(NO_EXCEPT) {
+        if(manipulator == static_cast<std::ostream& (*)(std::ostream&)>(std::endl)) this->put('\n');
+        return this->flush();
+    }
+
+    // `std::fixed`, `std::scientific`, ... and `std::setprecision(n)`.
+    inline fast_writer& operator<<(std::ios_base& (*const manipulator)(std::ios_base&)) noexcept(NO_EXCEPT) {
+        this->_format << manipulator;
+        return *this;
+    }
+
+    inline fast_writer& operator<<(const decltype(std::setprecision(0)) manipulator) noexcept(NO_EXCEPT) {
+        this->_format << manipulator;
+        return *this;
+    }
+
+    inline std::ios_base::fmtflags flags() const noexcept(NO_EXCEPT) { return this->_format.flags(); }
+    inline std::streamsize precision() const noexcept(NO_EXCEPT) { return this->_format.precision(); }
+
+    // Types printable only through `std::ostream` go through a scratch stream; those with `val()` are left to `output_adaptor`.
+    template<class T>
+        requires
+            (!std::is_arithmetic_v<std::remove_cvref_t<T>>) &&
+            (!std::convertible_to<const T&, std::string_view>) &&
+            (!requires (const T& val) { val.val(); }) &&
+            requires (std::ostream& out, const T& val) { out << val; }
+    inline fast_writer& operator<<(const T& val) noexcept(NO_EXCEPT) {
+        std::ostringstream out;
+        out.copyfmt(this->_format);
+        out << val;
+        return this->write(out.view());
+    }
+};
+
+
+} // namespace uni
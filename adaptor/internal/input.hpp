@@ -9,6 +9,7 @@
 #include <tuple>
 #include <ranges>
 #include <concepts>
+#include <cstdint>
 
 
 #include "snippet/aliases.hpp"
@@ -21,12 +22,26 @@
 #include "numeric/modular/modint_interface.hpp"
 
 #include "adaptor/valarray.hpp"
+#include "adaptor/internal/fast_reader.hpp"
 
 
 namespace uni {
 
+namespace internal {
 
-template<std::derived_from<std::ios_base> Source = std::istream>
+
+template<class T>
+concept input_source =
+    requires (T& in) {
+        typename T::char_type;
+        static_cast<bool>(in);
+    };
+
+
+} // namespace internal
+
+
+template<internal::input_source Source = std::istream>
 struct input_adaptor {
     using source_type = Source;
 
@@ -75,10 +90,51 @@ struct input_adaptor {
         return 0;
     }
 
+    // Read digit by digit, so that values beyond 64 bits are accepted as well.
+    // Streams are parsed straight from their buffer, as `fast_reader` does; other sources hand over a token.
     template<uni::internal::modint_family T>
     int _set(uni::internal::resolving_rank<1>, T& val) noexcept(NO_EXCEPT) {
-        std::int64_t v; std::cin >> v;
-        val = { v };
+        using builder = uni::internal::modint_builder<T>;
+        builder res;
+
+        if constexpr(std::derived_from<source_type, std::istream>) {
+            const typename source_type::sentry sentry(*this->in);
+            if(!sentry) return 0;
+
+            using traits = typename source_type::traits_type;
+            auto* const buffer = this->in->rdbuf();
+
+            auto c = buffer->sgetc();
+
+            bool negative = false;
+            if(c == '-' || c == '+') {
+                negative = c == '-';
+                c = buffer->snextc();
+            }
+
+            std::uint64_t chunk = 0;
+            int digits = 0;
+
+            for(; !traits::eq_int_type(c, traits::eof()) && static_cast<unsigned>(c - '0') < 10; c = buffer->snextc()) {
+                chunk = chunk * 10 + static_cast<std::uint64_t>(c - '0');
+                if(++digits == builder::CHUNK_DIGITS) res.push(chunk, digits), chunk = 0, digits = 0;
+            }
+            if(digits > 0) res.push(chunk, digits);
+
+            std::ios_base::iostate state = std::ios_base::goodbit;
+            if(traits::eq_int_type(c, traits::eof())) state |= std::ios_base::eofbit;
+            if(res.empty) state |= std::ios_base::failbit;
+            this->in->setstate(state);
+
+            val = negative ? -res.value : res.value;
+        }
+        else {
+            std::string token; *this >> token;
+            if(!res.push(token)) this->in->setstate(std::ios_base::failbit);
+
+            val = res.value;
+        }
+
         return 0;
     }
 
@@ -112,7 +168,10 @@ struct input_adaptor {
 
     source_type *in;
 
-    input_adaptor(source_type *_in = &std::cin) noexcept(NO_EXCEPT) : in(_in) {}
+    input_adaptor() noexcept(NO_EXCEPT) requires std::same_as<source_type, std::istream> : in(&std::cin) {}
+    input_adaptor() noexcept(NO_EXCEPT) requires std::same_as<source_type, fast_reader> : in(&fast_reader::standard()) {}
+
+    input_adaptor(source_type *_in) noexcept(NO_EXCEPT) : in(_in) {}
 
     template<class T>
     inline input_adaptor& operator>>(T&& s) noexcept(NO_EXCEPT) {
@@ -145,6 +204,19 @@ struct input_adaptor {
         return *this;
     }
 
+    // Contiguous ranges of integers are handed to the source at once, if it can parse them in bulk.
+    template<std::contiguous_iterator I, std::sized_sentinel_for<I> S>
+        requires
+            std::is_lvalue_reference_v<std::iter_reference_t<I>> &&
+            requires (source_type& in, std::iter_value_t<I>* data, std::size_t size) {
+                in.read(data, size);
+            } &&
+            uni::internal::readable_integer<std::iter_value_t<I>>
+    inline auto& operator()(I first, S last) noexcept(NO_EXCEPT) {
+        this->in->read(std::to_address(first), static_cast<std::size_t>(last - first));
+        return *this;
+    }
+
     explicit operator bool() const noexcept(NO_EXCEPT) { return (bool)*this->in; }
 };
 
@@ -7,21 +7,88 @@
 #include <vector>
 #include <iterator>
 #include <variant>
+#include <limits>
+#include <algorithm>
 #include <ranges>
+#include <string_view>
+#include <charconv>
+#include <cmath>
+#include <array>
+#include <concepts>
+#include <type_traits>
 
 
 #include "internal/dev_env.hpp"
 #include "internal/resolving_rank.hpp"
 
+#include "adaptor/internal/fast_writer.hpp"
+
 
 namespace uni {
 
 
-template<class Destination = std::ostream>
+// A separator (or terminator) chosen at run time through `output_adaptor::separator_type`.
+struct runtime_separator {};
+
+// A separator fixed at compile time, written without dispatching on `output_adaptor::separator_type`.
+template<char... Chars>
+struct literal_separator {
+    static constexpr char chars[] = { Chars..., '\0' };
+    static constexpr std::string_view value = { chars, sizeof...(Chars) };
+};
+
+using space_separator = literal_separator<' '>;
+using newline_separator = literal_separator<'\n'>;
+
+
+namespace internal {
+
+
+template<class T>
+concept fixed_separator =
+    requires {
+        { T::value } -> std::convertible_to<std::string_view>;
+    };
+
+
+} // namespace internal
+
+
+// e.g. `output_adaptor<fast_writer, newline_separator, space_separator>` for a buffered writer with fixed delimiters.
+template<class Destination = std::ostream, class EndlinePolicy = runtime_separator, class SeparatorPolicy = runtime_separator>
 struct output_adaptor {
     using destination_type = Destination;
 
   private:
+    template<class T>
+        requires std::floating_point<std::remove_cvref_t<T>>
+    int _put(uni::internal::resolving_rank<6>, T&& val) noexcept(NO_EXCEPT) {
+        const auto format = [&](char* const first, char* const last) {
+            if(this->precision < 0) return std::to_chars(first, last, val, this->float_format);
+            return std::to_chars(first, last, val, this->float_format, this->precision);
+        };
+
+        std::array<char, 128> buffer;
+        if(const auto [ ptr, error ] = format(buffer.begin(), buffer.end()); error == std::errc{}) {
+            std::string_view str(buffer.begin(), ptr);
+
+            // As `std::hexfloat` does.
+            if(this->float_format == std::chars_format::hex and std::isfinite(val)) {
+                if(str.front() == '-') *this->out << '-', str.remove_prefix(1);
+                *this->out << "0x";
+            }
+
+            *this->out << str;
+            return 0;
+        }
+
+        // Huge values in fixed notation, or a large precision.
+        std::string str(std::numeric_limits<std::remove_cvref_t<T>>::max_exponent10 + std::max(this->precision, 0) + 64, '\0');
+        str.resize(static_cast<std::size_t>(format(str.data(), str.data() + str.size()).ptr - str.data()));
+        *this->out << str;
+        return 0;
+    }
+
     template<class T>
         requires
             requires (destination_type& out, T val) {
@@ -97,24 +164,69 @@ struct output_adaptor {
     using separator_type = std::variant<std::string,sfunc_type>;
 
     destination_type *out;
-    separator_type endline;
-    separator_type separator;
+    [[no_unique_address]] std::conditional_t<internal::fixed_separator<EndlinePolicy>, EndlinePolicy, separator_type> endline;
+    [[no_unique_address]] std::conditional_t<internal::fixed_separator<SeparatorPolicy>, SeparatorPolicy, separator_type> separator;
+
+    // Floating-point values are written by `std::to_chars` in `float_format` with `precision` digits,
+    // or in the shortest form that reads back to the same value if `precision` is negative.
+    // Streaming a notation or precision manipulator resets both from the destination.
+    std::chars_format float_format = std::chars_format::fixed;
+    int precision = 20;
+
+  private:
+    template<class Policy, class T>
+    static auto _make_separator(T&& sep) noexcept(NO_EXCEPT) {
+        if constexpr(internal::fixed_separator<Policy>) return Policy{};
+        else return separator_type(std::forward<T>(sep));
+    }
+
+    template<class Policy, class T>
+    void _put_separator(const T& sep) noexcept(NO_EXCEPT) {
+        if constexpr(internal::fixed_separator<Policy>) {
+            if constexpr(Policy::value.size() == 1) *this->out << Policy::value[0];
+            else *this->out << Policy::value;
+        }
+        else {
+            if(sep.index() == 0) *this->out << std::get<std::string>(sep);
+            if(sep.index() == 1) *this->out << std::get<sfunc_type>(sep);
+        }
+    }
+
+    // Follows the floating-point notation and precision of the destination, after a manipulator has changed them.
+    void _adopt_float_format() noexcept(NO_EXCEPT) {
+        if constexpr(requires (destination_type& out) { out.flags(); out.precision(); }) {
+            const auto field = this->out->flags() & std::ios_base::floatfield;
+
+            if(field == std::ios_base::fixed) this->float_format = std::chars_format::fixed;
+            else if(field == std::ios_base::scientific) this->float_format = std::chars_format::scientific;
+            else if(field == std::ios_base::floatfield) this->float_format = std::chars_format::hex;
+            else this->float_format = std::chars_format::general;
+
+            // `std::hexfloat` prints every digit, whatever the precision is.
+            this->precision = field == std::ios_base::floatfield ? -1 : static_cast<int>(this->out->precision());
+        }
+    }
+
+    static destination_type* _standard() noexcept(NO_EXCEPT) {
+        if constexpr(std::same_as<destination_type, fast_writer>) return &fast_writer::standard();
+        else return &std::cout;
+    }
 
   protected:
     void put_separator() noexcept(NO_EXCEPT) {
-        if(this->separator.index() == 0) *this->out << std::get<std::string>(this->separator);
-        if(this->separator.index() == 1) *this->out << std::get<sfunc_type>(this->separator);
+        this->_put_separator<SeparatorPolicy>(this->separator);
     }
     void put_endline() noexcept(NO_EXCEPT) {
-        if(this->endline.index() == 0) *this->out << std::get<std::string>(this->endline);
-        if(this->endline.index() == 1) *this->out << std::get<sfunc_type>(this->endline);
+        this->_put_separator<EndlinePolicy>(this->endline);
     }
 
   public:
+    // With fixed policies, the corresponding arguments are ignored.
     template<class Terminator = std::string, class Separator = std::string>
-    output_adaptor(destination_type *des = &std::cout, Terminator endl = "\n", Separator sep = " ") noexcept(NO_EXCEPT)
-      : out(des), endline(endl), separator(sep)
+    output_adaptor(destination_type *des = _standard(), Terminator endl = "\n", Separator sep = " ") noexcept(NO_EXCEPT)
+      : out(des), endline(_make_separator<EndlinePolicy>(endl)), separator(_make_separator<SeparatorPolicy>(sep))
     {
+        // Sets `float_format` and `precision`, and the destination as well, for the types which write floating-point values through it by themselves.
         *this << std::fixed << std::setprecision(20);
     }
 
@@ -127,6 +239,20 @@ struct output_adaptor {
         return *this;
     }
 
+    // `std::fixed`, `std::scientific`, `std::hexfloat`, `std::defaultfloat`, and `std::setprecision(n)` apply to the destination,
+    // and to `float_format` and `precision` as well.
+    inline output_adaptor& operator<<(std::ios_base& (*const manipulator)(std::ios_base&)) noexcept(NO_EXCEPT) {
+        *this->out << manipulator;
+        this->_adopt_float_format();
+        return *this;
+    }
+
+    inline output_adaptor& operator<<(const decltype(std::setprecision(0)) manipulator) noexcept(NO_EXCEPT) {
+        *this->out << manipulator;
+        this->_adopt_float_format();
+        return *this;
+    }
+
     template<class T = std::string>
     inline auto& operator()(T&& val = "") noexcept(NO_EXCEPT){
         *this << std::forward<T>(val), this->put_endline();
@@ -66,6 +66,9 @@ struct associative {};
 
 struct commutative {};
 
+// `x + y` is always one of `x` and `y`.
+struct selective {};
+
 
 } // namespace algebraic
 
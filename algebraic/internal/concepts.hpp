@@ -31,6 +31,9 @@ concept associative = std::is_base_of_v<algebraic::associative, T>;
 template<class T>
 concept commutative = std::is_base_of_v<algebraic::commutative, T>;
 
+template<class T>
+concept selective = std::is_base_of_v<algebraic::selective, T>;
+
 template<class T>
 concept invertible = uni::internal::unary_subtractable<T>;
 
@@ -14,7 +14,7 @@ namespace algebraic {
 
 
 template<class T>
-struct minimum : base<T>, scalar_multipliable<minimum<T>>::identity, associative, commutative {
+struct minimum : base<T>, scalar_multipliable<minimum<T>>::identity, associative, commutative, selective {
     using base<T>::base;
 
     minimum() noexcept(NO_EXCEPT) : minimum(std::numeric_limits<T>::max()) {};
@@ -51,6 +51,10 @@ struct bit_vector {
     inline constexpr size_type zeros() const noexcept(NO_EXCEPT) { return this->_zeros; }
     inline constexpr size_type ones() const noexcept(NO_EXCEPT) { return this->_n - this->_zeros; }
 
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) {
+        return this->_block.capacity() * sizeof(std::uint64_t) + this->_count.capacity() * sizeof(size_type);
+    }
+
     inline void set(const size_type k) noexcept(NO_EXCEPT) { this->_block[k / WORDSIZE] |= (1LL << (k % WORDSIZE)); }
     inline bool get(const size_type k) const noexcept(NO_EXCEPT) {
         return 1U & static_cast<std::uint32_t>(this->_block[k / WORDSIZE] >> (k % WORDSIZE));
@@ -0,0 +1,232 @@
+#pragma once
+
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+#include <iterator>
+#include <utility>
+#include <type_traits>
+#include <ranges>
+#include <concepts>
+#include <bit>
+
+
+#include "snippet/iterations.hpp"
+
+#include "internal/dev_env.hpp"
+#include "internal/types.hpp"
+#include "internal/range_reference.hpp"
+#include "internal/unconstructible.hpp"
+
+#include "numeric/bit.hpp"
+#include "numeric/arithmetic.hpp"
+
+#include "algebraic/internal/concepts.hpp"
+#include "action/base.hpp"
+
+
+namespace uni {
+
+namespace internal {
+
+namespace block_sparse_table_impl {
+
+
+// `x + y` is always one of `x` and `y`, as for `algebraic::minimum` and `algebraic::maximum`; other operations opt in by deriving from `algebraic::selective`.
+template<class T>
+concept selective_semigroup =
+    algebraic::internal::semigroup<T> &&
+    algebraic::internal::commutative<T> &&
+    algebraic::internal::selective<T> &&
+    std::equality_comparable<T>;
+
+
+// Thanks to: https://codeforces.com/blog/entry/78931
+// The values are split into blocks of 64. Inside a block, each position keeps the stack of the suffix winners ending there as a bitmask,
+// so that a query within a block is a single `countr_zero`. A sparse table over the winners of the blocks covers the blocks in between.
+template<selective_semigroup Operand>
+struct core {
+    using size_type = internal::size_t;
+    using operand = Operand;
+
+    using iterator = typename std::vector<operand>::const_iterator;
+
+    static constexpr size_type BLOCK = 64;
+
+  private:
+    size_type _n = 0, _blocks = 0, _depth = 0;
+
+    std::vector<operand> _data;
+    std::vector<std::uint64_t> _masks;
+
+    // The level `k` at `k * blocks`: the fold of the blocks `[b, b + 2^k)` at `b`.
+    std::vector<operand> _table;
+
+
+    // The position of the winner of `[l, r]`, within a single block.
+    inline size_type _inner(const size_type l, const size_type r) const noexcept(NO_EXCEPT) {
+        return l + std::countr_zero(this->_masks[r] >> (l % BLOCK));
+    }
+
+    inline void _build() noexcept(NO_EXCEPT) {
+        REP(b, this->_blocks) {
+            const size_type first = b * BLOCK, last = std::min(first + BLOCK, this->_n);
+
+            std::uint64_t mask = 0;
+            REP(i, first, last) {
+                while(mask > 0) {
+                    const size_type top = first + std::bit_width(mask) - 1;
+                    if(!(this->_data[top] + this->_data[i] == this->_data[i])) break;
+                    mask ^= std::uint64_t{ 1 } << (top - first);
+                }
+                mask |= std::uint64_t{ 1 } << (i - first);
+                this->_masks[i] = mask;
+            }
+
+            this->_table[b] = this->_data[this->_inner(first, last - 1)];
+        }
+
+        FOR(k, 1, this->_depth - 1) {
+            const operand *const prev = this->_table.data() + (k - 1) * this->_blocks;
+            operand *const next = this->_table.data() + k * this->_blocks;
+
+            const size_type half = size_type{ 1 } << (k - 1);
+            REP(b, this->_blocks - (half << 1) + 1) next[b] = prev[b] + prev[b + half];
+        }
+    }
+
+  public:
+    core() noexcept = default;
+
+    template<std::input_iterator I, std::sized_sentinel_for<I> S>
+    core(I first, S last) noexcept(NO_EXCEPT)
+      : _n(static_cast<size_type>(std::ranges::distance(first, last))),
+        _blocks((this->_n + BLOCK - 1) / BLOCK),
+        _depth(std::bit_width(uni::to_unsigned(this->_blocks))),
+        _data(this->_n), _masks(this->_n), _table(this->_depth * this->_blocks)
+    {
+        std::ranges::copy(first, last, this->_data.begin());
+        this->_build();
+    }
+
+
+    inline size_type size() const noexcept(NO_EXCEPT) { return this->_n; }
+
+    inline const auto& data() const noexcept(NO_EXCEPT) { return this->_data; }
+
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) {
+        return
+            (this->_data.size() + this->_table.size()) * sizeof(operand) +
+            this->_masks.size() * sizeof(std::uint64_t);
+    }
+
+
+    operand fold(const size_type l, size_type r) const noexcept(NO_EXCEPT) {
+        if(l == r) return operand{};
+        --r;
+
+        const size_type bl = l / BLOCK, br = r / BLOCK;
+        if(bl == br) return this->_data[this->_inner(l, r)];
+
+        operand res = this->_data[this->_inner(l, bl * BLOCK + BLOCK - 1)] + this->_data[this->_inner(br * BLOCK, r)];
+
+        if(bl + 1 < br) {
+            const size_type k = highest_bit_pos(uni::to_unsigned(br - bl - 1));
+            const operand *const level = this->_table.data() + k * this->_blocks;
+            res = res + level[bl + 1] + level[br - (size_type{ 1 } << k)];
+        }
+
+        return res;
+    }
+};
+
+
+} // namespace block_sparse_table_impl
+
+} // namespace internal
+
+
+// Range folds of a static sequence under `min`, `max`, or any commutative operation whose result is always one of its operands,
+// in `O(1)` time after `O(n)` preprocessing, with `O(n)` memory.
+template<class> struct block_sparse_table : internal::unconstructible {};
+
+
+template<algebraic::internal::semigroup Semigroup>
+struct block_sparse_table<Semigroup> {
+    static_assert(algebraic::internal::selective<Semigroup>, "block_sparse_table needs an operation whose result is one of its operands, e.g. `algebraic::minimum`");
+    static_assert(algebraic::internal::commutative<Semigroup>);
+
+  private:
+    using core = internal::block_sparse_table_impl::core<Semigroup>;
+    using iterator = core::iterator;
+
+    core _impl;
+
+  public:
+    using value_type = Semigroup;
+    using size_type = core::size_type;
+
+  protected:
+    inline auto _positivize_index(const size_type p) const noexcept(NO_EXCEPT) {
+        return p < 0 ? this->_impl.size() + p : p;
+    }
+
+  public:
+    block_sparse_table() noexcept = default;
+
+    template<std::input_iterator I, std::sized_sentinel_for<I> S>
+    block_sparse_table(I first, S last) noexcept(NO_EXCEPT) : _impl(first, last) {}
+
+    template<std::ranges::input_range R>
+    explicit block_sparse_table(R&& range) noexcept(NO_EXCEPT)
+      : _impl(std::ranges::begin(range), std::ranges::end(range))
+    {}
+
+
+    inline auto size() const noexcept(NO_EXCEPT) { return this->_impl.size(); }
+
+    inline auto _memory() const noexcept(NO_EXCEPT) { return this->_impl._memory(); }
+
+
+    friend internal::range_reference<block_sparse_table>;
+
+    struct range_reference : internal::range_reference<block_sparse_table> {
+        range_reference(block_sparse_table *const super, const size_type l, const size_type r) noexcept(NO_EXCEPT)
+          : internal::range_reference<block_sparse_table>(super, super->_positivize_index(l), super->_positivize_index(r))
+        {
+            assert(0 <= this->_begin && this->_begin <= this->_end && this->_end <= this->_super->size());
+        }
+
+        inline auto fold() const noexcept(NO_EXCEPT) {
+            return this->_super->fold(this->_begin, this->_end);
+        }
+    };
+
+
+    inline auto fold(size_type l, size_type r) const noexcept(NO_EXCEPT) {
+        l = this->_positivize_index(l), r = this->_positivize_index(r);
+        assert(0 <= l && l <= r && r <= this->size());
+        return this->_impl.fold(l, r);
+    }
+    inline auto fold() const noexcept(NO_EXCEPT) { return this->fold(0, this->size()); }
+
+    inline auto operator[](const size_type index) const noexcept(NO_EXCEPT) { return this->_impl.data()[index]; }
+    inline auto operator()(const size_type l, const size_type r) noexcept(NO_EXCEPT) { return range_reference(this, l, r); }
+
+    inline auto begin() const noexcept(NO_EXCEPT) { return this->_impl.data().begin(); }
+    inline auto end() const noexcept(NO_EXCEPT) { return this->_impl.data().end(); }
+
+    inline auto rbegin() const noexcept(NO_EXCEPT) { return this->_impl.data().rbegin(); }
+    inline auto rend() const noexcept(NO_EXCEPT) { return this->_impl.data().rend(); }
+};
+
+
+template<actions::internal::operatable_action Action>
+struct block_sparse_table<Action> : block_sparse_table<typename Action::operand> {
+    using block_sparse_table<typename Action::operand>::block_sparse_table;
+};
+
+
+} // namespace uni
@@ -9,6 +9,7 @@
 #include <ranges>
 #include <concepts>
 #include <bit>
+#include <span>
 
 
 #include "internal/dev_env.hpp"
@@ -16,6 +17,8 @@
 #include "internal/concepts.hpp"
 #include "internal/range_reference.hpp"
 #include "internal/unconstructible.hpp"
+#include "internal/parallel.hpp"
+#include "internal/aligned_allocator.hpp"
 
 #include "numeric/bit.hpp"
 
@@ -36,18 +39,22 @@ struct core {
     using size_type = internal::size_t;
     using operand = Operand;
 
-    using iterator = std::vector<std::vector<Operand>>;
+    using iterator = typename std::span<const operand>::iterator;
 
     size_type _n = 0, _depth = 0;
     bool _built = false;
 
   protected:
-    std::vector<std::vector<operand>> _table = {};
+    // The rows `0, 1, ..., depth - 1` of `n` values each, one after another; the front row holds the values themselves.
+    std::vector<operand, internal::aligned_allocator<operand>> _table = {};
+
+    inline operand* _row(const size_type k) noexcept(NO_EXCEPT) { return this->_table.data() + k * this->_n; }
+    inline const operand* _row(const size_type k) const noexcept(NO_EXCEPT) { return this->_table.data() + k * this->_n; }
 
   public:
     explicit core(const size_type n = 0) noexcept(NO_EXCEPT) : _n(n) {
         this->_depth = std::bit_width<std::make_unsigned_t<size_type>>(n);
-        this->_table.resize(this->_depth+1, std::vector<operand>(n));
+        this->_table.resize(this->_depth * n);
     }
 
 
@@ -55,55 +62,81 @@ struct core {
     core(I first, S last) noexcept(NO_EXCEPT)
       : core(static_cast<size_type>(std::ranges::distance(first, last)))
     {
-        std::ranges::copy(first, last, this->_table.begin()->begin());
+        std::ranges::copy(first, last, this->_row(0));
     }
 
 
+  private:
+    // Each row reads only the front one.
+    inline void _build_row(const size_type i) noexcept(NO_EXCEPT) {
+        const size_type len = 1 << i;
+
+        const operand *const front = this->_row(0);
+        operand *const row = this->_row(i - 1);
+
+        for(size_type l = 0, m = (len >> 1); m < this->_n; l += len, m = l + (len >> 1)) {
+            row[m - 1] = front[m - 1];
+            REPD(j, l, m-1) {
+                row[j] = front[j] + row[j + 1];
+            }
+
+            row[m] = front[m];
+            REP(j, m + 1, std::min(l + len, this->_n)) {
+                row[j] = row[j - 1] + front[j];
+            }
+        }
+    }
+
+  public:
     template<bool FORCE = false>
     inline auto& build() noexcept(NO_EXCEPT) {
         if(!FORCE and this->_built) return *this;
 
-        FOR(i, 2, this->_depth) {
-            const size_type len = 1 << i;
+        FOR(i, 2, this->_depth) this->_build_row(i);
 
-            for(size_type l = 0, m = (len >> 1); m < this->_n; l += len, m = l + (len >> 1)) {
-                this->_table[i - 1][m - 1] = this->_table.front()[m - 1];
-                REPD(j, l, m-1) {
-                    this->_table[i - 1][j] = this->_table.front()[j] + this->_table[i - 1][j + 1];
-                }
+        this->_built = true;
 
-                this->_table[i - 1][m] = this->_table.front()[m];
-                REP(j, m + 1, std::min(l + len, this->_n)) {
-                    this->_table[i - 1][j] = this->_table[i - 1][j - 1] + this->_table.front()[j];
-                }
-            }
-        }
+        return *this;
+    }
+
+    // The rows cost `O(n)` each, and are shared among the workers.
+    template<bool FORCE = false>
+    inline auto& build(const parallel& policy) noexcept(NO_EXCEPT) {
+        if(!FORCE and this->_built) return *this;
+
+        const size_type grain = this->_n >= internal::PARALLEL_GRAIN ? 1 : this->_depth;
+        internal::parallel_for(policy, 2, this->_depth + 1, [this](const size_type first, const size_type last) {
+            REP(i, first, last) this->_build_row(i);
+        }, grain);
 
         this->_built = true;
 
         return *this;
     }
 
-    inline auto& raw() noexcept(NO_EXCEPT) {
+    inline std::span<operand> raw() noexcept(NO_EXCEPT) {
         this->_built = false;
-        return this->_table.front();
+        return { this->_row(0), static_cast<std::size_t>(this->_n) };
     }
 
-    inline const auto& raw() const noexcept(NO_EXCEPT) { return this->_table.front(); }
+    inline std::span<const operand> raw() const noexcept(NO_EXCEPT) { return { this->_row(0), static_cast<std::size_t>(this->_n) }; }
 
     inline auto& data() noexcept(NO_EXCEPT) { return this->_table; }
     inline const auto& data() const noexcept(NO_EXCEPT) { return this->_table; }
 
     size_type size() const noexcept(NO_EXCEPT) { return this->_n; }
 
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) { return this->_table.size() * sizeof(operand); }
+
     operand fold(const size_type l, size_type r) {
         if(l == r) return operand{};
-        if(l == --r) return this->_table.front()[l];
+        if(l == --r) return this->_row(0)[l];
 
         this->build();
 
         const size_type p = highest_bit_pos<std::make_unsigned_t<size_type>>(l ^ r);
-        return this->_table[p][l] + this->_table[p][r];
+        const operand *const row = this->_row(p);
+        return row[l] + row[r];
     }
 };
 
@@ -137,7 +170,7 @@ struct disjoint_sparse_table<Semigroup> {
 
   public:
     explicit disjoint_sparse_table(const size_type n, const value_type& val = value_type()) noexcept(NO_EXCEPT) : _impl(n) {
-        this->_impl.data().begin()->assign(n, val);
+        std::ranges::fill(this->_impl.raw(), val);
     }
 
     template<std::input_iterator I, std::sized_sentinel_for<I> S>
@@ -149,12 +182,23 @@ struct disjoint_sparse_table<Semigroup> {
     {}
 
 
-    inline auto& raw() noexcept(NO_EXCEPT) { return this->_impl.raw(); }
-    inline const auto& raw() const noexcept(NO_EXCEPT) { return this->_impl.raw(); }
-    inline const auto& data() const noexcept(NO_EXCEPT) { return this->impl.data(); }
+    // A `std::span` over the values (formerly a `std::vector&`); writing through the mutable one rebuilds the table on the next fold.
+    inline auto raw() noexcept(NO_EXCEPT) { return this->_impl.raw(); }
+    inline auto raw() const noexcept(NO_EXCEPT) { return this->_impl.raw(); }
+
+    // The rows one after another, `n` values each (formerly a vector of rows); the row `k` starts at `k * size()`.
+    inline const auto& data() const noexcept(NO_EXCEPT) { return this->_impl.data(); }
 
     inline auto size() const noexcept(NO_EXCEPT) { return this->_impl.size(); }
 
+    inline auto _memory() const noexcept(NO_EXCEPT) { return this->_impl._memory(); }
+
+    // Builds the table ahead of the first fold, sharing the rows among the workers of `policy`.
+    inline auto& build(const parallel& policy) noexcept(NO_EXCEPT) {
+        this->_impl.template build<true>(policy);
+        return *this;
+    }
+
 
     friend internal::range_reference<disjoint_sparse_table>;
 
@@ -178,14 +222,14 @@ struct disjoint_sparse_table<Semigroup> {
     }
     inline auto fold() noexcept(NO_EXCEPT) { return this->fold(0, this->size()); }
 
-    inline auto operator[](const size_type index) const noexcept(NO_EXCEPT) { return this->_impl.data().front()[index]; }
+    inline auto operator[](const size_type index) const noexcept(NO_EXCEPT) { return this->_impl.raw()[index]; }
     inline auto operator()(const size_type l, const size_type r) noexcept(NO_EXCEPT) { return range_reference(this, l, r); }
 
-    inline auto begin() const noexcept(NO_EXCEPT) { return this->_impl.data().begin()->begin(); }
-    inline auto end() const noexcept(NO_EXCEPT) { return this->_impl.data().begin()->end(); }
+    inline auto begin() const noexcept(NO_EXCEPT) { return this->_impl.raw().begin(); }
+    inline auto end() const noexcept(NO_EXCEPT) { return this->_impl.raw().end(); }
 
-    inline auto rbegin() const noexcept(NO_EXCEPT) { return this->_impl.data().begin()->rbegin(); }
-    inline auto rend() const noexcept(NO_EXCEPT) { return this->_impl.data().begin()->rend(); }
+    inline auto rbegin() const noexcept(NO_EXCEPT) { return this->_impl.raw().rbegin(); }
+    inline auto rend() const noexcept(NO_EXCEPT) { return this->_impl.raw().rend(); }
 };
 
 
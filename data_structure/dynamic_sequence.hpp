@@ -156,6 +156,42 @@ struct sequence_core
     }
 
 
+    using pending = typename base::pending;
+
+    // The node as `push()` would leave it, and what it would hand down to its children, computed without writing back.
+    // `above` is what the parent of `tree` hands down.
+    inline auto peek(const node_pointer& tree, const pending& above) const noexcept(NO_EXCEPT) {
+        data_type data = tree->data;
+        data.rev ^= above.rev;
+
+        if constexpr(LAZY) {
+            if constexpr(Context::LEAF_ONLY) {
+                if(tree->is_leaf()) {
+                    data.val = ActionOrValue::mapping(above.lazy, data.val);
+                }
+                else {
+                    data.lazy = above.lazy + data.lazy;
+                    data.val = ActionOrValue::mapping(ActionOrValue::power(above.lazy, tree->size), data.val);
+                }
+            }
+            else {
+                data.lazy = above.lazy + data.lazy;
+                data.acc = ActionOrValue::mapping(ActionOrValue::power(above.lazy, tree->size), data.acc);
+            }
+        }
+
+        const pending below = { data.lazy, data.rev };
+
+        if constexpr(LAZY) {
+            data.val = ActionOrValue::mapping(data.lazy, data.val);
+            data.lazy = operation{};
+        }
+        data.rev = false;
+
+        return std::make_pair(data, below);
+    }
+
+
     inline void update(node_pointer& tree) noexcept(NO_EXCEPT) {
         if(tree == node_handler::nil) return;
         this->base::push(tree);
@@ -884,15 +920,19 @@ struct dynamic_sequence
     using dumper::_debug;
 
 
-    debugger::debug_t dump_rich(const std::string prefix = "   ") {
+    debugger::debug_t dump_rich(const std::string prefix = "   ") const {
         return "\n" + this->dump_rich(this->_root, prefix);
     }
 
 
-    debugger::debug_t _debug() {
+    debugger::debug_t _debug() const {
         return "[ " + this->_debug(this->_root) + " ]";
     }
 
+    std::size_t _memory() const {
+        return this->_impl.footprint(this->_root);
+    }
+
 };
 
 
@@ -77,6 +77,10 @@ struct set_core :  internal::basic_core<ActionOrValue, set_core<ActionOrValue, C
 
     inline constexpr void push(const node_pointer) const noexcept(NO_EXCEPT) { /* do nothing */ }
 
+    inline auto peek(const node_pointer& tree, const typename base::pending&) const noexcept(NO_EXCEPT) {
+        return std::make_pair(tree->data, typename base::pending{});
+    }
+
 
     template<std::random_access_iterator I, std::sized_sentinel_for<I> S>
     node_pointer build(I first, S last) {
@@ -476,14 +480,18 @@ struct dynamic_set<ActionOrValue, Context>
     using dumper::_debug;
 
 
-    debugger::debug_t dump_rich(const std::string prefix = "   ") {
+    debugger::debug_t dump_rich(const std::string prefix = "   ") const {
         return "\n" + this->dump_rich(this->_root, prefix);
     }
 
 
-    debugger::debug_t _debug() {
+    debugger::debug_t _debug() const {
         return "[ " + this->_debug(this->_root) + " ]";
     }
+
+    std::size_t _memory() const {
+        return this->_impl.footprint(this->_root);
+    }
 };
 
 
@@ -5,6 +5,7 @@
 #include <vector>
 #include <iterator>
 #include <utility>
+#include <tuple>
 #include <type_traits>
 #include <concepts>
 #include <ranges>
@@ -25,6 +26,8 @@
 #include "action/base.hpp"
 #include "algebraic/internal/concepts.hpp"
 
+#include "data_structure/internal/batch_query.hpp"
+
 
 namespace uni {
 
@@ -91,6 +94,38 @@ struct core {
         return s;
     }
 
+    // Answers the queries in order, while the first nodes of the queries `BATCH_FOLD_WIDTH` ahead are prefetched.
+    // Those are the only ones likely to be cold: the nodes met later cover longer ranges, and are fewer.
+    template<std::input_iterator I, std::sentinel_for<I> S, std::output_iterator<const operand&> O>
+    O fold(I first, S last, O out) const noexcept(NO_EXCEPT) {
+        const operand* const nodes = this->_data.data();
+
+        size_type l[BATCH_FOLD_WIDTH], r[BATCH_FOLD_WIDTH];
+        size_type head = 0, count = 0;
+
+        while(true) {
+            for(; count < BATCH_FOLD_WIDTH && first != last; ++count, ++first) {
+                const auto& query = *first;
+                const size_type lo = static_cast<size_type>(std::get<0>(query));
+                const size_type hi = static_cast<size_type>(std::get<1>(query));
+                assert(0 <= lo && lo <= hi && hi <= this->_n);
+
+                const size_type slot = (head + count) % BATCH_FOLD_WIDTH;
+                l[slot] = lo, r[slot] = hi;
+
+                if(hi > 0) __builtin_prefetch(nodes + hi - 1);
+                if(lo > 0) __builtin_prefetch(nodes + lo - 1);
+            }
+
+            if(count == 0) break;
+
+            *out++ = this->fold(l[head], r[head]);
+            head = (head + 1) % BATCH_FOLD_WIDTH, --count;
+        }
+
+        return out;
+    }
+
     inline operand get(size_type p) const noexcept(NO_EXCEPT) {
         return this->fold(p, p+1);
     }
@@ -280,6 +315,20 @@ struct fenwick_tree<Monoid> : internal::fenwick_tree_impl::core<Monoid> {
         return this->_impl.fold(this->_impl.size());
     }
 
+    // Answers the ranges `[l, r)` of `queries` together, writing the results to `out` in order.
+    template<std::ranges::input_range R, std::output_iterator<const value_type&> O>
+        requires internal::range_query<std::ranges::range_value_t<R>> && algebraic::internal::invertible<value_type>
+    inline O fold(R&& queries, O out) const noexcept(NO_EXCEPT) {
+        return this->_impl.fold(std::ranges::begin(queries), std::ranges::end(queries), out);
+    }
+
+    // Folds interleaved with point updates; each fold observes the updates before it.
+    template<std::ranges::input_range R, std::output_iterator<const value_type&> O>
+        requires std::same_as<std::ranges::range_value_t<R>, batch_query<value_type>> && algebraic::internal::invertible<value_type>
+    inline O process(R&& queries, O out) noexcept(NO_EXCEPT) {
+        return internal::process_batch(*this, std::ranges::begin(queries), std::ranges::end(queries), out);
+    }
+
     struct iterator;
 
   protected:
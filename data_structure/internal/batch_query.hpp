@@ -0,0 +1,102 @@
+#pragma once
+
+
+#include <cstdint>
+#include <array>
+#include <utility>
+#include <tuple>
+#include <iterator>
+#include <concepts>
+#include <ranges>
+
+
+#include "internal/dev_env.hpp"
+#include "internal/types.hpp"
+
+
+namespace uni {
+
+
+// An entry of the batched interface: a fold over `[l, r)`, or a point update which the folds after it observe.
+template<class T>
+struct batch_query {
+    using size_type = internal::size_t;
+    using value_type = T;
+
+    enum struct kinds : std::uint8_t { fold, set, add };
+
+    kinds kind = kinds::fold;
+    size_type l = 0, r = 0;
+    value_type value = {};
+
+    static constexpr batch_query fold(const size_type l, const size_type r) noexcept(NO_EXCEPT) {
+        return { kinds::fold, l, r, {} };
+    }
+
+    static constexpr batch_query set(const size_type p, const value_type& v) noexcept(NO_EXCEPT) {
+        return { kinds::set, p, p + 1, v };
+    }
+
+    static constexpr batch_query add(const size_type p, const value_type& v) noexcept(NO_EXCEPT) {
+        return { kinds::add, p, p + 1, v };
+    }
+};
+
+
+namespace internal {
+
+
+// `std::pair<I, I>`, `std::tuple<I, I>`, `std::array<I, 2>`, ...
+template<class T>
+concept range_query =
+    requires (const T& query) {
+        { std::get<0>(query) } -> std::convertible_to<internal::size_t>;
+        { std::get<1>(query) } -> std::convertible_to<internal::size_t>;
+    };
+
+
+// How many queries ahead the batched folds prefetch.
+inline constexpr internal::size_t BATCH_FOLD_WIDTH = 16;
+
+// The size in bytes from which a level of a tree is assumed to be out of cache.
+inline constexpr internal::size_t PREFETCH_THRESHOLD = 1 << 18;
+
+
+// Answers the runs of folds in groups, and applies the updates between them in order.
+template<class Tree, std::input_iterator I, std::sentinel_for<I> S, class O>
+    requires std::same_as<std::iter_value_t<I>, batch_query<typename Tree::value_type>>
+O process_batch(Tree& tree, I first, S last, O out) noexcept(NO_EXCEPT) {
+    using query = batch_query<typename Tree::value_type>;
+
+    std::array<std::pair<internal::size_t, internal::size_t>, BATCH_FOLD_WIDTH> pending;
+    internal::size_t count = 0;
+
+    const auto flush = [&]() {
+        out = tree.fold(std::ranges::subrange(pending.begin(), pending.begin() + count), out);
+        count = 0;
+    };
+
+    for(; first != last; ++first) {
+        const query& q = *first;
+
+        if(q.kind == query::kinds::fold) {
+            pending[count++] = { q.l, q.r };
+            if(count == BATCH_FOLD_WIDTH) flush();
+            continue;
+        }
+
+        if(count > 0) flush();
+
+        if(q.kind == query::kinds::set) tree.set(q.l, q.value);
+        else tree.add(q.l, q.value);
+    }
+
+    if(count > 0) flush();
+
+    return out;
+}
+
+
+} // namespace internal
+
+} // namespace uni
@@ -3,6 +3,8 @@
 
 #include <compare>
 #include <iterator>
+#include <vector>
+#include <unordered_set>
 
 
 #include "snippet/aliases.hpp"
@@ -98,6 +100,13 @@ struct basic_core
     using operation = data_type::lazy_t;
 
 
+    // What a node hands down to its children when it is pushed.
+    struct pending {
+        [[no_unique_address]] operation lazy = {};
+        bool rev = false;
+    };
+
+
     inline auto val(const node_pointer& node) const noexcept(NO_EXCEPT) {
         if constexpr(Context::LEAF_ONLY) {
             if(node->is_leaf()) return node->size * node->data.val;
@@ -220,6 +229,37 @@ struct basic_core
 
         return res;
     }
+
+
+    // The number of nodes in `tree`, which owns each of them exclusively; the depth of the recursion is that of the tree.
+    std::size_t node_count(const node_pointer& tree) const noexcept(NO_EXCEPT) {
+        if(!tree || tree == node_handler::nil) return 0;
+        return 1 + this->node_count(tree->left) + this->node_count(tree->right);
+    }
+
+    // Heap bytes held by the nodes reachable from `tree`; a node shared by several versions is counted once.
+    // Only persistent trees share nodes, and need to remember the visited ones for that.
+    std::size_t footprint(const node_pointer& tree) const {
+        if constexpr(!node_handler::PERSISTENT) {
+            return this->node_count(tree) * node_handler::node_footprint;
+        }
+        else {
+            std::unordered_set<const void*> visited;
+            std::vector<node_pointer> stack = { tree };
+
+            while(!stack.empty()) {
+                const node_pointer node = stack.back();
+                stack.pop_back();
+
+                if(!node || node == node_handler::nil || !visited.insert(&*node).second) continue;
+
+                stack.push_back(node->left);
+                stack.push_back(node->right);
+            }
+
+            return visited.size() * node_handler::node_footprint;
+        }
+    }
 };
 
 
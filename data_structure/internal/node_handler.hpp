@@ -1,6 +1,7 @@
 #pragma once
 
 
+#include <cstddef>
 #include <memory>
 
 #include "internal/dev_env.hpp"
@@ -70,6 +71,12 @@ struct cloneable {
 
         inline static node_pointer nil = std::make_shared<node_type>();
 
+        // Nodes may be shared by several versions.
+        static constexpr bool PERSISTENT = true;
+
+        // `allocate_shared` places each node next to its control block (a vtable pointer and two counters).
+        static constexpr std::size_t node_footprint = sizeof(node_type) + sizeof(void*) + 2 * sizeof(int);
+
         template<class... Args>
         inline auto create(Args&&... args) noexcept(NO_EXCEPT) {
             return std::allocate_shared<node_type>(this->_allocator, std::forward<Args>(args)...);
@@ -106,6 +113,10 @@ struct reusing {
 
         inline static node_pointer nil;
 
+        static constexpr bool PERSISTENT = false;
+
+        static constexpr std::size_t node_footprint = sizeof(node_type);
+
 
         handler(const allocator_type& allocator = allocator_type()) noexcept(NO_EXCEPT) : base(allocator) {
             if(handler::_instance_count++ == 0) {
@@ -0,0 +1,45 @@
+#pragma once
+
+
+#include <bit>
+
+
+#include "internal/dev_env.hpp"
+#include "internal/types.hpp"
+
+#include "numeric/arithmetic.hpp"
+
+
+namespace uni {
+
+namespace segment_tree_layouts {
+
+
+// Leaves at `bit_ceil(n)`: a perfect binary tree of `2 * bit_ceil(n)` nodes.
+struct perfect {};
+
+// Leaves at `n`: exactly `2n` nodes (and `n` lazy tags).
+// Nodes straddling the wrap-around between two leaf depths are kept but never read,
+// so that the folds stay correct for non-commutative monoids as well.
+struct compact {};
+
+
+namespace internal {
+
+
+// The number of levels below the node `k` of a compact tree of `n` leaves, provided that `k` covers a contiguous range.
+inline constexpr uni::internal::size_t height(const uni::internal::size_t n, const uni::internal::size_t k) noexcept(NO_EXCEPT) {
+    if(k >= n) return 0;
+
+    uni::internal::size_t res = std::bit_width(uni::to_unsigned(n)) - std::bit_width(uni::to_unsigned(k));
+    if((k << res) < n) ++res;
+
+    return res;
+}
+
+
+} // namespace internal
+
+} // namespace segment_tree_layouts
+
+} // namespace uni
@@ -2,6 +2,7 @@
 
 
 #include <string>
+#include <tuple>
 
 
 #include "snippet/aliases.hpp"
@@ -21,38 +22,41 @@ struct dumpable_tree {
 
     using size_type = Core::size_type;
 
-    inline auto _push(const node_pointer& tree) {
-        return static_cast<Derived*>(this)->_impl.push(tree);
-        // return static_cast<Derived*>(this)->push(tree);
+    using pending = Core::pending;
+
+    // Dumping only reads the tree: the pending operations are composed on the way down instead of being pushed.
+    inline auto _peek(const node_pointer& tree, const pending& above) const {
+        return static_cast<const Derived*>(this)->_impl.peek(tree, above);
     }
 
   public:
-    debugger::debug_t dump_rich(node_pointer tree, const std::string prefix, const int dir, size_type& index)
+    debugger::debug_t dump_rich(const node_pointer& tree, const std::string prefix, const int dir, size_type& index, const pending& above = {}) const
         requires (!LEAF_ONLY)
     {
         if(!tree || tree == node_handler::nil) return prefix + "\n";
 
-        this->_push(tree);
+        const auto [ data, below ] = this->_peek(tree, above);
+        const auto& [ first, second ] = below.rev ? std::tie(tree->right, tree->left) : std::tie(tree->left, tree->right);
 
-        // debug(tree->priority >= tree->left->priority, tree->priority, tree->left->priority);
-        // debug(tree->priority >= tree->right->priority, tree->priority, tree->right->priority);
-        assert(tree->priority >= tree->left->priority);
-        assert(tree->priority >= tree->right->priority);
+        // debug(tree->priority >= first->priority, tree->priority, first->priority);
+        // debug(tree->priority >= second->priority, tree->priority, second->priority);
+        assert(tree->priority >= first->priority);
+        assert(tree->priority >= second->priority);
 
-        const auto left = this->dump_rich(tree->left, prefix + (dir == 1 ? "| " : "  "), -1, index);
+        const auto left = this->dump_rich(first, prefix + (dir == 1 ? "| " : "  "), -1, index, below);
         const auto here =
             prefix + "--+ [" +
             debugger::dump(index) + ", " + debugger::dump(index + tree->length) + ") : " +
             "<" + debugger::dump(tree->priority) + "> " +
-            debugger::dump(tree->data) + " [" + debugger::dump(tree->length) + "]\n";
+            debugger::dump(data) + " [" + debugger::dump(tree->length) + "]\n";
         index += tree->length;
 
-        const auto right = this->dump_rich(tree->right, prefix + (dir == -1 ? "| " : "  "), 1, index);
+        const auto right = this->dump_rich(second, prefix + (dir == -1 ? "| " : "  "), 1, index, below);
 
         return left + here + right;
     }
 
-    debugger::debug_t dump_rich(node_pointer tree, const std::string prefix, const int dir, size_type& index)
+    debugger::debug_t dump_rich(const node_pointer& tree, const std::string prefix, const int dir, size_type& index, const pending& above = {}) const
         requires
             (
                 LEAF_ONLY &&
@@ -63,10 +67,11 @@ struct dumpable_tree {
     {
         if(!tree || tree == node_handler::nil) return prefix + "\n";
 
-        this->_push(tree);
+        const auto [ data, below ] = this->_peek(tree, above);
+        const auto& [ first, second ] = below.rev ? std::tie(tree->right, tree->left) : std::tie(tree->left, tree->right);
 
-        const auto left = this->dump_rich(tree->left, prefix + (dir == 1 ? "| " : "  "), -1, index);
-        const auto right = this->dump_rich(tree->right, prefix + (dir == -1 ? "| " : "  "), 1, index);
+        const auto left = this->dump_rich(first, prefix + (dir == 1 ? "| " : "  "), -1, index, below);
+        const auto right = this->dump_rich(second, prefix + (dir == -1 ? "| " : "  "), 1, index, below);
 
 
         const auto color = tree->color == Core::node_colors::BLACK ? "<->" : "<+>";
@@ -79,7 +84,7 @@ struct dumpable_tree {
                     prefix + "--+ [" +
                     debugger::dump(index - tree->size) + ", " + debugger::dump(index) + ") : " +
                     debugger::COLOR_STRING + color + debugger::COLOR_INIT + " " +
-                    debugger::dump(tree->data) + " [" + debugger::dump(tree->size) + "]\n";
+                    debugger::dump(data) + " [" + debugger::dump(tree->size) + "]\n";
             }
             return "";
         }();
@@ -88,47 +93,49 @@ struct dumpable_tree {
     }
 
 
-    inline debugger::debug_t dump_rich(const node_pointer& tree, const std::string prefix = "   ", const int dir = 0) {
+    inline debugger::debug_t dump_rich(const node_pointer& tree, const std::string prefix = "   ", const int dir = 0) const {
         size_type index = 0;
         return this->dump_rich(tree, prefix, dir, index);
     }
 
 
-    debugger::debug_t _debug(node_pointer tree)
+    debugger::debug_t _debug(const node_pointer& tree, const pending& above = {}) const
         requires (!LEAF_ONLY)
     {
         if(!tree || tree == node_handler::nil) return "";
 
-        this->_push(tree);
+        const auto [ data, below ] = this->_peek(tree, above);
+        const auto& [ first, second ] = below.rev ? std::tie(tree->right, tree->left) : std::tie(tree->left, tree->right);
 
         return
             "(" +
-            this->_debug(tree->left) + " " +
-            debugger::dump(tree->data) + " [" +
+            this->_debug(first, below) + " " +
+            debugger::dump(data) + " [" +
             debugger::dump(tree->length) + "] " +
-            this->_debug(tree->right) +
+            this->_debug(second, below) +
             ")";
     }
 
-    debugger::debug_t _debug(node_pointer tree)
+    debugger::debug_t _debug(const node_pointer& tree, const pending& above = {}) const
         requires LEAF_ONLY
     {
         if(!tree || tree == node_handler::nil) return "";
 
-        this->_push(tree);
+        const auto [ data, below ] = this->_peek(tree, above);
+        const auto& [ first, second ] = below.rev ? std::tie(tree->right, tree->left) : std::tie(tree->left, tree->right);
 
         return
             "(" +
-            this->_debug(tree->left) + " " +
+            this->_debug(first, below) + " " +
             (
                 tree->is_leaf()
                     ?
-                        debugger::dump(tree->data) + " [" +
+                        debugger::dump(data) + " [" +
                         debugger::dump(tree->size) + "] "
                     :
                         ""
             ) +
-            this->_debug(tree->right) +
+            this->_debug(second, below) +
             ")";
     }
 };
@@ -9,6 +9,7 @@
 #include <concepts>
 #include <ranges>
 #include <bit>
+#include <limits>
 
 
 #include "snippet/aliases.hpp"
@@ -18,6 +19,7 @@
 #include "internal/iterator.hpp"
 #include "internal/point_reference.hpp"
 #include "internal/range_reference.hpp"
+#include "internal/parallel.hpp"
 
 #include "numeric/bit.hpp"
 #include "numeric/arithmetic.hpp"
@@ -27,6 +29,8 @@
 #include "action/base.hpp"
 #include "action/helpers.hpp"
 
+#include "data_structure/internal/segment_tree_layout.hpp"
+
 
 namespace uni {
 
@@ -68,6 +72,18 @@ struct core {
         this->_lazy[p] = operation{};
     }
 
+    // Composes the pending operations on the way down, leaving the tree untouched.
+    void _peek(const size_type p, const operation& above, std::vector<operand>& res) const noexcept(NO_EXCEPT) {
+        if(p >= this->_size) {
+            if(p - this->_size < this->_n) res[p - this->_size] = action::mapping(action::power(above, this->_lengths[p]), this->_values[p]);
+            return;
+        }
+
+        const operation below = above + this->_lazy[p];
+        this->_peek(p << 1, below, res);
+        this->_peek(p << 1 | 1, below, res);
+    }
+
     inline void _init() noexcept(NO_EXCEPT) {
         REPD(p, 1, this->_size) {
             this->_lengths[p] = this->_lengths[p << 1] + this->_lengths[p << 1 | 1];
@@ -88,9 +104,23 @@ struct core {
     inline size_type allocated() const noexcept(NO_EXCEPT) { return this->_values.size(); }
     inline size_type depth() const noexcept(NO_EXCEPT) { return this->_depth; }
 
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) {
+        return
+            this->_lengths.size() * sizeof(size_type) +
+            this->_values.size() * sizeof(operand) +
+            this->_lazy.size() * sizeof(operation);
+    }
+
 
     inline operand fold_all() const noexcept(NO_EXCEPT) { return this->_values[1]; }
 
+    // The current values, read without pushing the pending operations.
+    inline std::vector<operand> values() const noexcept(NO_EXCEPT) {
+        std::vector<operand> res(this->_n);
+        if(this->_n > 0) this->_peek(1, operation{}, res);
+        return res;
+    }
+
 
     inline void fill( const operand& v = operand()) noexcept(NO_EXCEPT) {
         REP(p, 0, this->_n) {
@@ -111,6 +141,21 @@ struct core {
         this->_init();
     }
 
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S>
+    inline void assign(const parallel& policy, I first, S last) noexcept(NO_EXCEPT) {
+        assert(std::ranges::distance(first, last) == this->_n);
+
+        internal::parallel_for(policy, 0, this->_n, [&](const size_type begin, const size_type end) {
+            REP(p, begin, end) {
+                this->_lengths[this->_size + p] = 1, this->_values[this->_size + p] = static_cast<operand>(first[p]);
+            }
+        });
+        internal::parallel_pull(policy, this->_size, [this](const size_type p) {
+            this->_lengths[p] = this->_lengths[p << 1] + this->_lengths[p << 1 | 1];
+            this->_pull(p);
+        });
+    }
+
 
     inline void set(size_type p, const operand& x) noexcept(NO_EXCEPT) {
         p += this->_size;
@@ -249,26 +294,319 @@ struct core {
 };
 
 
+// Leaves at [n, 2n), so that the lengths are derived from the indices instead of being stored.
+// Nodes which straddle two depths never receive an operation; pushing and pulling them is harmless.
+template<actions::internal::full_action Action>
+    requires
+        algebraic::internal::monoid<typename Action::operand> &&
+        algebraic::internal::monoid<typename Action::operation>
+struct compact_core {
+    using size_type = internal::size_t;
+
+    using action = Action;
+    using operand = typename Action::operand;
+    using operation = typename Action::operation;
+
+ private:
+    size_type _n = 0;
+    std::valarray<operand> _values;
+    std::valarray<operation> _lazy;
+
+
+    inline size_type _length(const size_type p) const noexcept(NO_EXCEPT) {
+        return size_type{ 1 } << segment_tree_layouts::internal::height(this->_n, p);
+    }
+
+    inline static size_type _levels(const size_type p) noexcept(NO_EXCEPT) {
+        return std::bit_width(uni::to_unsigned(p)) - 1;
+    }
+
+    inline void _pull(const size_type p) noexcept(NO_EXCEPT) {
+        this->_values[p] = this->_values[p << 1] + this->_values[p << 1 | 1];
+    }
+
+    // Pulls a node which may still hold an operation of its own.
+    inline void _rebuild(const size_type p) noexcept(NO_EXCEPT) {
+        this->_values[p] = action::mapping(action::power(this->_lazy[p], this->_length(p)), this->_values[p << 1] + this->_values[p << 1 | 1]);
+    }
+
+    inline void _all_apply(const size_type p, const operation& f) noexcept(NO_EXCEPT) {
+        this->_values[p] = action::mapping(action::power(f, this->_length(p)), this->_values[p]);
+        if(p < this->_n) this->_lazy[p] = f + this->_lazy[p];
+    }
+
+    inline void _push(const size_type p) noexcept(NO_EXCEPT) {
+        this->_all_apply(p << 1, this->_lazy[p]);
+        this->_all_apply(p << 1 | 1, this->_lazy[p]);
+        this->_lazy[p] = operation{};
+    }
+
+    inline void _push_ancestors(const size_type p) noexcept(NO_EXCEPT) {
+        FORD(i, 1, _levels(p)) this->_push(p >> i);
+    }
+
+    inline void _pull_ancestors(size_type p) noexcept(NO_EXCEPT) {
+        while(p >>= 1) this->_pull(p);
+    }
+
+    void _peek(const size_type p, const operation& above, std::vector<operand>& res) const noexcept(NO_EXCEPT) {
+        if(p >= this->_n) {
+            res[p - this->_n] = action::mapping(action::power(above, 1), this->_values[p]);
+            return;
+        }
+
+        const operation below = above + this->_lazy[p];
+        this->_peek(p << 1, below, res);
+        this->_peek(p << 1 | 1, below, res);
+    }
+
+    inline void _init() noexcept(NO_EXCEPT) {
+        REPD(p, 1, this->_n) this->_pull(p);
+    }
+
+  public:
+    compact_core() noexcept = default;
+
+    explicit compact_core(const size_type n) noexcept(NO_EXCEPT) : _n(n), _values(n << 1), _lazy(n) {}
+
+
+    inline size_type size() const noexcept(NO_EXCEPT) { return this->_n; }
+    inline size_type allocated() const noexcept(NO_EXCEPT) { return this->_values.size(); }
+    inline size_type depth() const noexcept(NO_EXCEPT) { return std::bit_width(uni::to_unsigned(this->_n)); }
+
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) {
+        return
+            this->_values.size() * sizeof(operand) +
+            this->_lazy.size() * sizeof(operation);
+    }
+
+
+    inline operand fold_all() noexcept(NO_EXCEPT) { return this->fold(0, this->_n); }
+
+    // The current values, read without pushing the pending operations.
+    inline std::vector<operand> values() const noexcept(NO_EXCEPT) {
+        std::vector<operand> res(this->_n);
+        if(this->_n > 0) this->_peek(1, operation{}, res);
+        return res;
+    }
+
+
+    inline void fill( const operand& v = operand()) noexcept(NO_EXCEPT) {
+        REP(p, 0, this->_n) this->_values[this->_n + p] = v;
+        this->_lazy = operation{};
+        this->_init();
+    }
+
+    template<std::input_iterator I, std::sentinel_for<I> S>
+    inline void assign(I first, S last) noexcept(NO_EXCEPT) {
+        if constexpr(std::sized_sentinel_for<operand, I>) {
+            assert(std::ranges::distance(first, last) == this->_n);
+        }
+        size_type p = 0;
+        for(auto itr=first; itr!=last; ++itr, ++p) this->_values[this->_n + p] = static_cast<operand>(*itr);
+        this->_lazy = operation{};
+        this->_init();
+    }
+
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S>
+    inline void assign(const parallel& policy, I first, S last) noexcept(NO_EXCEPT) {
+        assert(std::ranges::distance(first, last) == this->_n);
+
+        internal::parallel_for(policy, 0, this->_n, [&](const size_type begin, const size_type end) {
+            REP(p, begin, end) {
+                this->_values[this->_n + p] = static_cast<operand>(first[p]);
+                this->_lazy[p] = operation{};
+            }
+        });
+        internal::parallel_pull(policy, this->_n, [this](const size_type p) { this->_pull(p); });
+    }
+
+
+    inline void set(size_type p, const operand& x) noexcept(NO_EXCEPT) {
+        p += this->_n;
+        this->_push_ancestors(p);
+        this->_values[p] = x;
+        this->_pull_ancestors(p);
+    }
+
+    inline void add(size_type p, const operand& x) noexcept(NO_EXCEPT) {
+        p += this->_n;
+        this->_push_ancestors(p);
+        this->_values[p] = this->_values[p] + x;
+        this->_pull_ancestors(p);
+    }
+
+    inline operand get(size_type p) noexcept(NO_EXCEPT) {
+        p += this->_n;
+        this->_push_ancestors(p);
+        return this->_values[p];
+    }
+
+    inline operand fold(size_type l, size_type r) noexcept(NO_EXCEPT) {
+        if(l == r) return {};
+
+        l += this->_n;
+        r += this->_n;
+
+        this->_push_ancestors(l);
+        this->_push_ancestors(r - 1);
+
+        operand sml = operand{}, smr = operand{};
+        while(l < r) {
+            if(l & 1) sml = sml + this->_values[l++];
+            if(r & 1) smr = this->_values[--r] + smr;
+            l >>= 1;
+            r >>= 1;
+        }
+
+        return sml + smr;
+    }
+
+
+    inline void apply(size_type p, const operation& f) noexcept(NO_EXCEPT) {
+        p += this->_n;
+        this->_push_ancestors(p);
+        this->_values[p] = action::mapping(action::power(f, 1), this->_values[p]);
+        this->_pull_ancestors(p);
+    }
+
+    inline void apply(size_type l, size_type r, const operation& f) noexcept(NO_EXCEPT) {
+        if(l == r) return;
+
+        l += this->_n;
+        r += this->_n;
+
+        this->_push_ancestors(l);
+        this->_push_ancestors(r - 1);
+
+        {
+            size_type l2 = l, r2 = r;
+            while(l < r) {
+                if(l & 1) this->_all_apply(l++, f);
+                if(r & 1) this->_all_apply(--r, f);
+                l >>= 1;
+                r >>= 1;
+            }
+            l = l2;
+            r = r2;
+        }
+
+        // The ancestors of the boundaries may have been covered themselves, hence keep their own operations.
+        FOR(i, 1, _levels(l)) this->_rebuild(l >> i);
+        FOR(i, 1, _levels(r - 1)) this->_rebuild((r - 1) >> i);
+    }
+
+
+    // The nodes of [l, n) are visited in order: those of the left boundary while climbing, then those of the right one, stacked.
+    template<class F>
+    inline size_type max_right(size_type l, F&& f) noexcept(NO_EXCEPT) {
+        assert(0 <= l && l <= this->_n);
+        assert(f(operand{}));
+
+        if(l == this->_n) return this->_n;
+
+        this->_push_ancestors(l + this->_n);
+        this->_push_ancestors((this->_n << 1) - 1);
+
+        operand sm;
+
+        const auto descend = [&](size_type k) {
+            while(k < this->_n) {
+                this->_push(k);
+                k <<= 1;
+                if(f(sm + this->_values[k])) sm = sm + this->_values[k++];
+            }
+            return k - this->_n;
+        };
+
+        size_type stack[std::numeric_limits<size_type>::digits];
+        size_type count = 0;
+
+        for(size_type lo = l + this->_n, hi = this->_n << 1; lo < hi; lo >>= 1, hi >>= 1) {
+            if(lo & 1) {
+                if(!f(sm + this->_values[lo])) return descend(lo);
+                sm = sm + this->_values[lo++];
+            }
+            if(hi & 1) stack[count++] = --hi;
+        }
+
+        while(count > 0) {
+            const size_type k = stack[--count];
+            if(!f(sm + this->_values[k])) return descend(k);
+            sm = sm + this->_values[k];
+        }
+
+        return this->_n;
+    }
+
+    template<class F>
+    inline size_type min_left(size_type r, F&& f) noexcept(NO_EXCEPT) {
+        assert(0 <= r && r <= this->_n);
+        assert(f(operand{}));
+
+        if(r == 0) return 0;
+
+        this->_push_ancestors(this->_n);
+        this->_push_ancestors(r - 1 + this->_n);
+
+        operand sm;
+
+        const auto descend = [&](size_type k) {
+            while(k < this->_n) {
+                this->_push(k);
+                k = k << 1 | 1;
+                if(f(this->_values[k] + sm)) sm = this->_values[k--] + sm;
+            }
+            return k + 1 - this->_n;
+        };
+
+        size_type stack[std::numeric_limits<size_type>::digits];
+        size_type count = 0;
+
+        for(size_type lo = this->_n, hi = r + this->_n; lo < hi; lo >>= 1, hi >>= 1) {
+            if(hi & 1) {
+                --hi;
+                if(!f(this->_values[hi] + sm)) return descend(hi);
+                sm = this->_values[hi] + sm;
+            }
+            if(lo & 1) stack[count++] = lo++;
+        }
+
+        while(count > 0) {
+            const size_type k = stack[--count];
+            if(!f(this->_values[k] + sm)) return descend(k);
+            sm = this->_values[k] + sm;
+        }
+
+        return 0;
+    }
+};
+
+
 } // namespace lazy_segment_tree_impl
 
 } // namespace internal
 
 
-template<class T>
-struct lazy_segment_tree : lazy_segment_tree<actions::make_full_t<T>> {
-    using lazy_segment_tree<actions::make_full_t<T>>::lazy_segment_tree;
+template<class T, class Layout = segment_tree_layouts::perfect>
+struct lazy_segment_tree : lazy_segment_tree<actions::make_full_t<T>, Layout> {
+    using lazy_segment_tree<actions::make_full_t<T>, Layout>::lazy_segment_tree;
 };
 
 
-template<actions::internal::full_action Action>
+template<actions::internal::full_action Action, class Layout>
     requires internal::available<internal::lazy_segment_tree_impl::core<Action>>
-struct lazy_segment_tree<Action> {
+struct lazy_segment_tree<Action, Layout> {
     using action = Action;
     using operand = Action::operand;
     using operation = Action::operation;
 
   private:
-    using core = internal::lazy_segment_tree_impl::core<action>;
+    using core = std::conditional_t<
+        std::same_as<Layout, segment_tree_layouts::compact>,
+        internal::lazy_segment_tree_impl::compact_core<action>,
+        internal::lazy_segment_tree_impl::core<action>
+    >;
 
     core _impl;
 
@@ -282,6 +620,8 @@ struct lazy_segment_tree<Action> {
     inline auto allocated() const noexcept(NO_EXCEPT) { return this->_impl.allocated(); }
     inline auto depth() const noexcept(NO_EXCEPT) { return this->_impl.depth(); }
 
+    inline auto _memory() const noexcept(NO_EXCEPT) { return this->_impl._memory(); }
+
   protected:
     inline size_type _positivize_index(const size_type p) const noexcept(NO_EXCEPT) {
         return p < 0 ? this->_impl.size() + p : p;
@@ -303,6 +643,12 @@ struct lazy_segment_tree<Action> {
     template<std::ranges::input_range R>
     explicit lazy_segment_tree(R&& range) noexcept(NO_EXCEPT) : lazy_segment_tree(ALL(range)) {}
 
+    template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    lazy_segment_tree(const parallel& policy, R&& range) noexcept(NO_EXCEPT)
+      : _impl(static_cast<size_type>(std::ranges::size(range)))
+    { this->assign(policy, ALL(range)); }
+
     template<std::convertible_to<value_type> T>
     inline auto& assign(const std::initializer_list<T>& init_list) noexcept(NO_EXCEPT)
     {
@@ -318,6 +664,17 @@ struct lazy_segment_tree<Action> {
     template<std::ranges::input_range R>
     inline auto& assign(R&& range) noexcept(NO_EXCEPT) { return this->assign(ALL(range)); }
 
+    // Shares the leaves, then each level of the tree, among the workers of `policy`.
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S>
+    inline auto& assign(const parallel& policy, I first, S last) noexcept(NO_EXCEPT) {
+        this->_impl.assign(policy, first, last);
+        return *this;
+    }
+
+    template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    inline auto& assign(const parallel& policy, R&& range) noexcept(NO_EXCEPT) { return this->assign(policy, ALL(range)); }
+
     inline auto& fill( const value_type& v = value_type()) noexcept(NO_EXCEPT) {
         this->impl.fill(v);
         return *this;
@@ -452,6 +809,9 @@ struct lazy_segment_tree<Action> {
 
     inline auto rbegin() noexcept(NO_EXCEPT) { return std::make_reverse_iterator(this->end()); }
     inline auto rend() noexcept(NO_EXCEPT) { return std::make_reverse_iterator(this->begin()); }
+
+
+    inline auto _debug() const noexcept(NO_EXCEPT) { return this->_impl.values(); }
 };
 
 
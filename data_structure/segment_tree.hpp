@@ -4,10 +4,14 @@
 #include <cassert>
 #include <algorithm>
 #include <vector>
+#include <valarray>
+#include <iterator>
+#include <tuple>
 #include <type_traits>
 #include <concepts>
 #include <ranges>
 #include <bit>
+#include <limits>
 
 
 #include "snippet/iterations.hpp"
@@ -18,11 +22,15 @@
 #include "internal/point_reference.hpp"
 #include "internal/range_reference.hpp"
 #include "internal/unconstructible.hpp"
+#include "internal/parallel.hpp"
 
 #include "numeric/bit.hpp"
 #include "algebraic/internal/concepts.hpp"
 #include "action/base.hpp"
 
+#include "data_structure/internal/segment_tree_layout.hpp"
+#include "data_structure/internal/batch_query.hpp"
+
 
 namespace uni {
 
@@ -31,6 +39,63 @@ namespace internal {
 namespace segment_tree_impl {
 
 
+// Answers the queries in order, while the nodes of the queries `BATCH_FOLD_WIDTH` ahead are prefetched.
+// Only the levels too large to stay cached are prefetched; the leaves are at `[offset, offset + n)`.
+// The walk selects the sums instead of branching on the parity of the bounds, which is unpredictable.
+template<class Operand, std::input_iterator I, std::sentinel_for<I> S, std::output_iterator<const Operand&> O>
+O fold_batch(const std::valarray<Operand>& data, const internal::size_t offset, const internal::size_t n, I first, S last, O out) noexcept(NO_EXCEPT) {
+    using size_type = internal::size_t;
+
+    const Operand* const nodes = std::begin(data);
+
+    size_type cold = 0;
+    while(((offset >> cold) * static_cast<size_type>(sizeof(Operand))) > PREFETCH_THRESHOLD) ++cold;
+
+    size_type l[BATCH_FOLD_WIDTH], r[BATCH_FOLD_WIDTH];
+    size_type head = 0, count = 0;
+
+    const auto fold = [&](size_type lo, size_type hi) {
+        Operand sml, smr;
+        while(lo < hi) {
+            const bool take_l = lo & 1, take_r = hi & 1;
+            const Operand next_l = sml + nodes[lo], next_r = nodes[hi - 1] + smr;
+            sml = take_l ? next_l : sml;
+            smr = take_r ? next_r : smr;
+            lo = (lo + take_l) >> 1;
+            hi >>= 1;
+        }
+        return sml + smr;
+    };
+
+    while(true) {
+        for(; count < BATCH_FOLD_WIDTH && first != last; ++count, ++first) {
+            const auto& query = *first;
+            size_type lo = static_cast<size_type>(std::get<0>(query));
+            size_type hi = static_cast<size_type>(std::get<1>(query));
+            assert(0 <= lo && lo <= hi && hi <= n);
+
+            lo += offset, hi += offset;
+
+            const size_type slot = (head + count) % BATCH_FOLD_WIDTH;
+            l[slot] = lo, r[slot] = hi;
+
+            REP(level, cold) {
+                if((lo >> level) >= (hi >> level)) break;
+                __builtin_prefetch(nodes + (lo >> level));
+                __builtin_prefetch(nodes + ((hi - 1) >> level));
+            }
+        }
+
+        if(count == 0) break;
+
+        *out++ = fold(l[head], r[head]);
+        head = (head + 1) % BATCH_FOLD_WIDTH, --count;
+    }
+
+    return out;
+}
+
+
 // Thanks to: atcoder::segtree
 template<algebraic::internal::monoid Monoid>
 struct core {
@@ -62,6 +127,8 @@ struct core {
 
     inline operand fold_all() const noexcept(NO_EXCEPT) { return this->_data[1]; }
 
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) { return this->_data.size() * sizeof(operand); }
+
 
     template<std::input_iterator I, std::sentinel_for<I> S>
     inline void assign(I first, S last) noexcept(NO_EXCEPT) {
@@ -75,6 +142,16 @@ struct core {
         REPD(p, 1, this->_size) this->_pull(p);
     }
 
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S>
+    inline void assign(const parallel& policy, I first, S last) noexcept(NO_EXCEPT) {
+        assert(std::ranges::distance(first, last) == this->_n);
+
+        internal::parallel_for(policy, 0, this->_n, [&](const size_type begin, const size_type end) {
+            REP(p, begin, end) this->_data[this->_size + p] = static_cast<operand>(first[p]);
+        });
+        internal::parallel_pull(policy, this->_size, [this](const size_type p) { this->_pull(p); });
+    }
+
     inline void fill(const operand& v = operand()) noexcept(NO_EXCEPT) {
         REP(p, this->_n) this->_data[this->_size + p] = v;
         REPD(p, 1, this->_size) this->_pull(p);
@@ -109,6 +186,11 @@ struct core {
         return sml + smr;
     }
 
+    template<std::input_iterator I, std::sentinel_for<I> S, std::output_iterator<const operand&> O>
+    inline O fold(I first, S last, O out) const noexcept(NO_EXCEPT) {
+        return fold_batch(this->_data, this->_size, this->_n, first, last, out);
+    }
+
 
     template<class F>
     inline size_type max_right(size_type l, F&& f) const noexcept(NO_EXCEPT) {
@@ -178,19 +260,195 @@ struct core {
 
 
 
+// Thanks to: https://codeforces.com/blog/entry/18051
+// The leaves are placed at [n, 2n); only the nodes met by the bottom-up walk of a fold are read, all of which cover a contiguous range.
+template<algebraic::internal::monoid Monoid>
+struct compact_core {
+    using size_type = internal::size_t;
+
+    using operand = Monoid;
+
+  protected:
+    size_type _n = 0;
+    std::valarray<operand> _data;
+
+    inline void _pull(const size_type k) noexcept(NO_EXCEPT) {
+        this->_data[k] = this->_data[k << 1] + this->_data[k << 1 | 1];
+    }
+
+  public:
+    compact_core() noexcept = default;
+
+    explicit compact_core(const size_type n) noexcept(NO_EXCEPT) : _n(n), _data(n << 1) {}
+
+
+    inline size_type size() const noexcept(NO_EXCEPT) { return this->_n; }
+    inline size_type allocated() const noexcept(NO_EXCEPT) { return this->_data.size(); }
+    inline size_type depth() const noexcept(NO_EXCEPT) { return std::bit_width(uni::to_unsigned(this->_n)); }
+
+
+    inline operand fold_all() const noexcept(NO_EXCEPT) { return this->fold(0, this->_n); }
+
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) { return this->_data.size() * sizeof(operand); }
+
+
+    template<std::input_iterator I, std::sentinel_for<I> S>
+    inline void assign(I first, S last) noexcept(NO_EXCEPT) {
+        if constexpr(std::sized_sentinel_for<S, I>) {
+            assert(std::ranges::distance(first, last) == this->_n);
+        }
+        {
+            size_type p = 0;
+            for(auto itr=first; itr!=last; ++itr, ++p) this->_data[this->_n + p] = static_cast<operand>(*itr);
+        }
+        REPD(p, 1, this->_n) this->_pull(p);
+    }
+
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S>
+    inline void assign(const parallel& policy, I first, S last) noexcept(NO_EXCEPT) {
+        assert(std::ranges::distance(first, last) == this->_n);
+
+        internal::parallel_for(policy, 0, this->_n, [&](const size_type begin, const size_type end) {
+            REP(p, begin, end) this->_data[this->_n + p] = static_cast<operand>(first[p]);
+        });
+        internal::parallel_pull(policy, this->_n, [this](const size_type p) { this->_pull(p); });
+    }
+
+    inline void fill(const operand& v = operand()) noexcept(NO_EXCEPT) {
+        REP(p, this->_n) this->_data[this->_n + p] = v;
+        REPD(p, 1, this->_n) this->_pull(p);
+    }
+
+
+    inline void add(size_type p, const operand& x) noexcept(NO_EXCEPT) {
+        this->set(p, this->_data[p + this->_n] + x);
+    }
+
+    inline void set(size_type p, const operand& x) noexcept(NO_EXCEPT) {
+        p += this->_n;
+        this->_data[p] = x;
+        while(p >>= 1) this->_pull(p);
+    }
+
+    inline operand get(size_type p) const noexcept(NO_EXCEPT) {
+        return this->_data[p + this->_n];
+    }
+
+    inline operand fold(size_type l, size_type r) const noexcept(NO_EXCEPT) {
+        operand sml, smr;
+        l += this->_n;
+        r += this->_n;
+
+        while(l < r) {
+            if(l & 1) sml = sml + this->_data[l++];
+            if(r & 1) smr = this->_data[--r] + smr;
+            l >>= 1;
+            r >>= 1;
+        }
+        return sml + smr;
+    }
+
+    template<std::input_iterator I, std::sentinel_for<I> S, std::output_iterator<const operand&> O>
+    inline O fold(I first, S last, O out) const noexcept(NO_EXCEPT) {
+        return fold_batch(this->_data, this->_n, this->_n, first, last, out);
+    }
+
+
+    // The nodes of [l, n) are visited in order: those of the left boundary while climbing, then those of the right one, stacked.
+    template<class F>
+    inline size_type max_right(size_type l, F&& f) const noexcept(NO_EXCEPT) {
+        assert(0 <= l && l <= this->_n);
+        assert(f(operand{}));
+
+        if(l == this->_n) return this->_n;
+
+        operand acc;
+
+        const auto descend = [&](size_type k) {
+            while(k < this->_n) {
+                k <<= 1;
+                if(f(acc + this->_data[k])) acc = acc + this->_data[k++];
+            }
+            return k - this->_n;
+        };
+
+        size_type stack[std::numeric_limits<size_type>::digits];
+        size_type count = 0;
+
+        for(size_type lo = l + this->_n, hi = this->_n << 1; lo < hi; lo >>= 1, hi >>= 1) {
+            if(lo & 1) {
+                if(!f(acc + this->_data[lo])) return descend(lo);
+                acc = acc + this->_data[lo++];
+            }
+            if(hi & 1) stack[count++] = --hi;
+        }
+
+        while(count > 0) {
+            const size_type k = stack[--count];
+            if(!f(acc + this->_data[k])) return descend(k);
+            acc = acc + this->_data[k];
+        }
+
+        return this->_n;
+    }
+
+    template<class F>
+    inline size_type min_left(size_type r, F&& f) const noexcept(NO_EXCEPT) {
+        assert(0 <= r && r <= this->_n);
+        assert(f(operand{}));
+
+        if(r == 0) return 0;
+
+        operand acc;
+
+        const auto descend = [&](size_type k) {
+            while(k < this->_n) {
+                k = k << 1 | 1;
+                if(f(this->_data[k] + acc)) acc = this->_data[k--] + acc;
+            }
+            return k + 1 - this->_n;
+        };
+
+        size_type stack[std::numeric_limits<size_type>::digits];
+        size_type count = 0;
+
+        for(size_type lo = this->_n, hi = r + this->_n; lo < hi; lo >>= 1, hi >>= 1) {
+            if(hi & 1) {
+                --hi;
+                if(!f(this->_data[hi] + acc)) return descend(hi);
+                acc = this->_data[hi] + acc;
+            }
+            if(lo & 1) stack[count++] = lo++;
+        }
+
+        while(count > 0) {
+            const size_type k = stack[--count];
+            if(!f(this->_data[k] + acc)) return descend(k);
+            acc = this->_data[k] + acc;
+        }
+
+        return 0;
+    }
+};
+
+
 } // namespace segment_tree_impl
 
 } // namespace internal
 
 
-template<class T>
+template<class T, class Layout = segment_tree_layouts::perfect>
 struct segment_tree : internal::unconstructible {};
 
 
-template<algebraic::internal::monoid Monoid>
-struct segment_tree<Monoid> {
+template<algebraic::internal::monoid Monoid, class Layout>
+struct segment_tree<Monoid, Layout> {
   private:
-    using core = typename internal::segment_tree_impl::core<Monoid>;
+    using core = std::conditional_t<
+        std::same_as<Layout, segment_tree_layouts::compact>,
+        internal::segment_tree_impl::compact_core<Monoid>,
+        internal::segment_tree_impl::core<Monoid>
+    >;
 
     core _impl;
 
@@ -218,11 +476,19 @@ struct segment_tree<Monoid> {
     template<std::ranges::input_range R>
     explicit segment_tree(R&& range) noexcept(NO_EXCEPT) : segment_tree(ALL(range)) {}
 
+    template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    segment_tree(const parallel& policy, R&& range) noexcept(NO_EXCEPT)
+      : segment_tree(static_cast<size_type>(std::ranges::size(range)))
+    { this->assign(policy, ALL(range)); }
+
 
     inline auto size() const noexcept(NO_EXCEPT) { return this->_impl.size(); }
     inline auto allocated() const noexcept(NO_EXCEPT) { return this->_impl.allocated(); }
     inline auto depth() const noexcept(NO_EXCEPT) { return this->_impl.depth(); }
 
+    inline auto _memory() const noexcept(NO_EXCEPT) { return this->_impl._memory(); }
+
 
     template<std::convertible_to<value_type> T>
     inline auto& assign(const std::initializer_list<T>& init_list) noexcept(NO_EXCEPT) { return this->assign(ALL(init_list)); }
@@ -236,6 +502,17 @@ struct segment_tree<Monoid> {
     template<std::ranges::input_range R>
     inline auto& assign(R&& range) noexcept(NO_EXCEPT) { return this->assign(ALL(range)); }
 
+    // Shares the leaves, then each level of the tree, among the workers of `policy`.
+    template<std::random_access_iterator I, std::sized_sentinel_for<I> S>
+    inline auto& assign(const parallel& policy, I first, S last) noexcept(NO_EXCEPT) {
+        this->_impl.assign(policy, first, last);
+        return *this;
+    }
+
+    template<std::ranges::random_access_range R>
+        requires std::ranges::sized_range<R>
+    inline auto& assign(const parallel& policy, R&& range) noexcept(NO_EXCEPT) { return this->assign(policy, ALL(range)); }
+
     inline auto& fill(const value_type& v = value_type()) noexcept(NO_EXCEPT) {
         this->_impl.fill(v);
         return *this;
@@ -310,6 +587,20 @@ struct segment_tree<Monoid> {
         return this->_impl.fold_all();
     }
 
+    // Answers the ranges `[l, r)` of `queries` together, writing the results to `out` in order.
+    template<std::ranges::input_range R, std::output_iterator<const value_type&> O>
+        requires internal::range_query<std::ranges::range_value_t<R>>
+    inline O fold(R&& queries, O out) const noexcept(NO_EXCEPT) {
+        return this->_impl.fold(std::ranges::begin(queries), std::ranges::end(queries), out);
+    }
+
+    // Folds interleaved with point updates; each fold observes the updates before it.
+    template<std::ranges::input_range R, std::output_iterator<const value_type&> O>
+        requires std::same_as<std::ranges::range_value_t<R>, batch_query<value_type>>
+    inline O process(R&& queries, O out) noexcept(NO_EXCEPT) {
+        return internal::process_batch(*this, std::ranges::begin(queries), std::ranges::end(queries), out);
+    }
+
 
     template<bool (*f)(value_type)>
     inline auto max_right(const size_type l) const noexcept(NO_EXCEPT) {
@@ -351,9 +642,9 @@ struct segment_tree<Monoid> {
 };
 
 
-template<actions::internal::operatable_action Action>
-struct segment_tree<Action> : segment_tree<typename Action::operand> {
-    using segment_tree<typename Action::operand>::segment_tree;
+template<actions::internal::operatable_action Action, class Layout>
+struct segment_tree<Action, Layout> : segment_tree<typename Action::operand, Layout> {
+    using segment_tree<typename Action::operand, Layout>::segment_tree;
 };
 
 
@@ -77,6 +77,14 @@ struct base {
     inline size_type size() const noexcept(NO_EXCEPT) { return this->_n; }
     inline size_type bits() const noexcept(NO_EXCEPT) { return this->_bits; }
 
+    // The levels only; the hash table of first positions is not counted.
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) {
+        std::size_t res = this->_index.capacity() * sizeof(bit_vector) + this->_sum.capacity() * sizeof(std::vector<impl_type>);
+        for(const auto& level : this->_index) res += level._memory();
+        for(const auto& level : this->_sum) res += level.capacity() * sizeof(impl_type);
+        return res;
+    }
+
     template<std::ranges::input_range R>
     inline void build(R&& range) noexcept(NO_EXCEPT) { this->build(ALL(range)); }
 
@@ -540,6 +548,10 @@ struct compressed_wavelet_matrix : protected wavelet_matrix<u32, MapTemplate> {
     }
 
     inline auto get(const size_type k) const noexcept(NO_EXCEPT) { return this->_comp.value(this->core::get(k)); }
+
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) {
+        return this->core::_memory() + this->_comp.size() * sizeof(u32) + this->_comp.values.capacity() * sizeof(value_type);
+    }
     inline auto operator[](const size_type k) const noexcept(NO_EXCEPT) { return this->_comp.value(this->core::get(k)); }
 
 
@@ -0,0 +1,550 @@
+#pragma once
+
+
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <memory>
+#include <new>
+#include <vector>
+#include <type_traits>
+#include <concepts>
+#include <ranges>
+#include <bit>
+#include <array>
+#include <limits>
+
+
+#include "snippet/iterations.hpp"
+
+#include "internal/dev_env.hpp"
+#include "internal/types.hpp"
+#include "internal/iterator.hpp"
+#include "internal/point_reference.hpp"
+#include "internal/range_reference.hpp"
+#include "internal/unconstructible.hpp"
+
+#include "algebraic/addition.hpp"
+#include "algebraic/minimum.hpp"
+#include "algebraic/maximum.hpp"
+#include "action/base.hpp"
+
+
+namespace uni {
+
+namespace internal {
+
+namespace wide_segment_tree_impl {
+
+
+template<class Monoid>
+concept vectorizable_monoid =
+    requires { typename Monoid::value_type; } &&
+    std::is_arithmetic_v<typename Monoid::value_type> &&
+    !std::same_as<typename Monoid::value_type, bool> &&
+    sizeof(typename Monoid::value_type) <= 8 &&
+    (
+        std::same_as<Monoid, algebraic::addition<typename Monoid::value_type>> ||
+        std::same_as<Monoid, algebraic::minimum<typename Monoid::value_type>> ||
+        std::same_as<Monoid, algebraic::maximum<typename Monoid::value_type>>
+    );
+
+
+// Thanks to: https://en.algorithmica.org/hpc/data-structures/segment-trees/
+// Each level is stored contiguously in nodes of `Width` values (by default a cache line), folded lane-parallel;
+// a query reads at most two nodes per level, over log_{Width}(n) levels instead of log_2(n).
+template<vectorizable_monoid Monoid, std::size_t Width>
+    requires (Width >= 2 && std::has_single_bit(Width))
+struct core {
+    using size_type = internal::size_t;
+
+    using operand = Monoid;
+    using value_type = typename operand::value_type;
+
+    static constexpr size_type WIDTH = static_cast<size_type>(Width);
+
+  private:
+    using lane_type = std::conditional_t<sizeof(value_type) == 1, std::int8_t,
+        std::conditional_t<sizeof(value_type) == 2, std::int16_t,
+        std::conditional_t<sizeof(value_type) == 4, std::int32_t, std::int64_t>>>;
+
+    // Nodes are processed in registers of 32 bytes.
+    static constexpr std::size_t LANES = std::min<std::size_t>(32 / sizeof(value_type), Width);
+    static constexpr std::size_t CHUNKS = Width / LANES;
+
+    typedef value_type vector __attribute__((vector_size(sizeof(value_type) * LANES)));
+    typedef lane_type mask __attribute__((vector_size(sizeof(lane_type) * LANES)));
+
+    static constexpr std::size_t ALIGNMENT = std::max<std::size_t>(sizeof(value_type) * Width, 64);
+
+    struct deleter {
+        inline void operator()(value_type *const ptr) const noexcept {
+            ::operator delete[](ptr, std::align_val_t{ ALIGNMENT });
+        }
+    };
+
+    static constexpr value_type IDENTITY = [] {
+        if constexpr(std::same_as<operand, algebraic::addition<value_type>>) return value_type{ 0 };
+        if constexpr(std::same_as<operand, algebraic::minimum<value_type>>) return std::numeric_limits<value_type>::max();
+        if constexpr(std::same_as<operand, algebraic::maximum<value_type>>) return std::numeric_limits<value_type>::lowest();
+    }();
+
+    // A window of `Width` lanes at `WIDTH - l` selects the lanes [l, Width), and one at `2 * WIDTH - r` the lanes [0, r).
+    static constexpr auto MASKS = [] {
+        std::array<lane_type, 3 * Width> res{};
+        REP(i, Width, 2 * Width) res[i] = -1;
+        return res;
+    }();
+
+    template<class T>
+    __attribute__((target("avx2"), always_inline))
+    static inline T _op(const T& lhs, const T& rhs) noexcept(NO_EXCEPT) {
+        if constexpr(std::same_as<operand, algebraic::addition<value_type>>) return lhs + rhs;
+        if constexpr(std::same_as<operand, algebraic::minimum<value_type>>) return rhs < lhs ? rhs : lhs;
+        if constexpr(std::same_as<operand, algebraic::maximum<value_type>>) return lhs < rhs ? rhs : lhs;
+    }
+
+
+    size_type _n = 0;
+
+    // Level 0 holds the leaves; each following level folds `WIDTH` values of the previous one, up to a single root.
+    std::vector<size_type> _offset, _length;
+
+    std::unique_ptr<value_type[], deleter> _data;
+    size_type _allocated = 0;
+
+
+    inline value_type* _node(const size_type level, const size_type k) const noexcept(NO_EXCEPT) {
+        return this->_data.get() + this->_offset[level] + k * WIDTH;
+    }
+
+    __attribute__((target("avx2"), always_inline))
+    inline void _load(const size_type level, const size_type k, const size_type chunk, vector& res) const noexcept(NO_EXCEPT) {
+        std::memcpy(&res, std::assume_aligned<sizeof(vector)>(this->_node(level, k) + chunk * LANES), sizeof(vector));
+    }
+
+    template<std::size_t Lanes>
+    struct lanes {
+        typedef value_type type __attribute__((vector_size(sizeof(value_type) * Lanes)));
+    };
+
+    // Folds the halves of `v` onto each other until a single lane is left.
+    template<std::size_t Lanes = LANES>
+    __attribute__((target("avx2"), always_inline))
+    static inline value_type _reduce(const typename lanes<Lanes>::type& v) noexcept(NO_EXCEPT) {
+        if constexpr(Lanes == 2) return _op(v[0], v[1]);
+        else {
+            typename lanes<Lanes / 2>::type low, high;
+            std::memcpy(&low, &v, sizeof(low));
+            std::memcpy(&high, reinterpret_cast<const char*>(&v) + sizeof(low), sizeof(high));
+            return _reduce<Lanes / 2>(_op(low, high));
+        }
+    }
+
+    // The fold of the lanes [l, r) of the k-th node on `level`.
+    __attribute__((target("avx2"), always_inline))
+    inline value_type _fold_node(const size_type level, const size_type k, const size_type l, const size_type r) const noexcept(NO_EXCEPT) {
+        const vector identity = vector{} + IDENTITY;
+        vector acc = identity;
+
+        REP(chunk, CHUNKS) {
+            vector v; this->_load(level, k, chunk, v);
+
+            mask from, to;
+            std::memcpy(&from, MASKS.data() + WIDTH - l + chunk * LANES, sizeof(mask));
+            std::memcpy(&to, MASKS.data() + 2 * WIDTH - r + chunk * LANES, sizeof(mask));
+
+            acc = _op(acc, (from & to) ? v : identity);
+        }
+
+        return _reduce(acc);
+    }
+
+    __attribute__((target("avx2")))
+    inline void _pull(const size_type level, const size_type k) noexcept(NO_EXCEPT) {
+        vector acc; this->_load(level, k, 0, acc);
+        REP(chunk, 1, CHUNKS) {
+            vector v; this->_load(level, k, chunk, v);
+            acc = _op(acc, v);
+        }
+        this->_node(level + 1, 0)[k] = _reduce(acc);
+    }
+
+    __attribute__((target("avx2")))
+    void _build(const size_type level) noexcept(NO_EXCEPT) {
+        REP(k, this->_length[level + 1]) this->_pull(level, k);
+    }
+
+    void _allocate() noexcept(NO_EXCEPT) {
+        const std::size_t bytes = sizeof(value_type) * this->_allocated;
+        this->_data.reset(static_cast<value_type*>(::operator new[](bytes, std::align_val_t{ ALIGNMENT })));
+    }
+
+  public:
+    core() noexcept = default;
+
+    explicit core(const size_type n) noexcept(NO_EXCEPT) : _n(n) {
+        this->_length.push_back(n);
+        while(this->_length.back() > 1) this->_length.push_back((this->_length.back() + WIDTH - 1) / WIDTH);
+
+        for(const auto length : this->_length) {
+            this->_offset.push_back(this->_allocated);
+            this->_allocated += std::max<size_type>((length + WIDTH - 1) / WIDTH, 1) * WIDTH;
+        }
+
+        this->_allocate();
+        std::fill(this->_data.get(), this->_data.get() + this->_allocated, IDENTITY);
+    }
+
+    core(const core& source) noexcept(NO_EXCEPT)
+      : _n(source._n), _offset(source._offset), _length(source._length), _allocated(source._allocated)
+    {
+        this->_allocate();
+        std::copy(source._data.get(), source._data.get() + this->_allocated, this->_data.get());
+    }
+
+    core(core&&) noexcept = default;
+
+    core& operator=(const core& source) noexcept(NO_EXCEPT) {
+        if(this != &source) *this = core(source);
+        return *this;
+    }
+
+    core& operator=(core&&) noexcept = default;
+
+
+    inline size_type size() const noexcept(NO_EXCEPT) { return this->_n; }
+    inline size_type allocated() const noexcept(NO_EXCEPT) { return this->_allocated; }
+    inline size_type depth() const noexcept(NO_EXCEPT) { return static_cast<size_type>(this->_length.size()) - 1; }
+
+
+    inline operand fold_all() const noexcept(NO_EXCEPT) {
+        if(this->_n == 0) return operand{};
+        return this->_node(this->depth(), 0)[0];
+    }
+
+    inline std::size_t _memory() const noexcept(NO_EXCEPT) {
+        return this->_allocated * sizeof(value_type) + (this->_offset.capacity() + this->_length.capacity()) * sizeof(size_type);
+    }
+
+
+    template<std::input_iterator I, std::sentinel_for<I> S>
+    __attribute__((target("avx2")))
+    void assign(I first, S last) noexcept(NO_EXCEPT) {
+        if constexpr(std::sized_sentinel_for<S, I>) {
+            assert(std::ranges::distance(first, last) == this->_n);
+        }
+        {
+            size_type p = 0;
+            for(auto itr=first; itr!=last; ++itr, ++p) this->_data[p] = static_cast<operand>(*itr).val();
+        }
+        REP(level, this->depth()) this->_build(level);
+    }
+
+    __attribute__((target("avx2")))
+    void fill(const operand& v = operand()) noexcept(NO_EXCEPT) {
+        std::fill(this->_data.get(), this->_data.get() + this->_n, v.val());
+        REP(level, this->depth()) this->_build(level);
+    }
+
+
+    inline void add(const size_type p, const operand& x) noexcept(NO_EXCEPT) {
+        this->set(p, this->get(p) + x);
+    }
+
+    __attribute__((target("avx2")))
+    void set(size_type p, const operand& x) noexcept(NO_EXCEPT) {
+        this->_data[p] = x.val();
+        REP(level, this->depth()) this->_pull(level, p /= WIDTH);
+    }
+
+    inline operand get(const size_type p) const noexcept(NO_EXCEPT) {
+        return this->_data[p];
+    }
+
+    __attribute__((target("avx2")))
+    operand fold(size_type l, size_type r) const noexcept(NO_EXCEPT) {
+        value_type acc = IDENTITY;
+
+        // The monoids are commutative, so both ends may be folded in any order.
+        for(size_type level = 0; l < r; ++level) {
+            const size_type kl = l / WIDTH, kr = (r - 1) / WIDTH;
+
+            if(kl == kr) {
+                acc = _op(acc, this->_fold_node(level, kl, l % WIDTH, (r - 1) % WIDTH + 1));
+                break;
+            }
+
+            if(l % WIDTH) acc = _op(acc, this->_fold_node(level, kl, l % WIDTH, WIDTH)), l = kl + 1;
+            else l = kl;
+
+            if(r % WIDTH) acc = _op(acc, this->_fold_node(level, kr, 0, r % WIDTH)), r = kr;
+            else r = kr + 1;
+        }
+
+        return acc;
+    }
+
+
+    template<class F>
+    size_type max_right(size_type l, F&& f) const noexcept(NO_EXCEPT) {
+        assert(0 <= l && l <= this->_n);
+        assert(f(operand{}));
+
+        if(l == this->_n) return this->_n;
+
+        operand acc;
+        size_type level = 0;
+
+        while(true) {
+            const size_type end = std::min((l / WIDTH + 1) * WIDTH, this->_length[level]);
+
+            for(; l < end; ++l) {
+                const operand next = acc + operand(this->_node(level, 0)[l]);
+
+                if(!f(next)) {
+                    while(level > 0) {
+                        --level, l *= WIDTH;
+                        while(true) {
+                            const operand child = acc + operand(this->_node(level, 0)[l]);
+                            if(!f(child)) break;
+                            acc = child, ++l;
+                        }
+                    }
+                    return l;
+                }
+
+                acc = next;
+            }
+
+            if(end == this->_length[level]) return this->_n;
+
+            l = end / WIDTH, ++level;
+        }
+    }
+
+    template<class F>
+    size_type min_left(size_type r, F&& f) const noexcept(NO_EXCEPT) {
+        assert(0 <= r && r <= this->_n);
+        assert(f(operand{}));
+
+        if(r == 0) return 0;
+
+        operand acc;
+        size_type level = 0;
+
+        while(true) {
+            const size_type begin = (r - 1) / WIDTH * WIDTH;
+
+            for(; r > begin; --r) {
+                const operand next = operand(this->_node(level, 0)[r - 1]) + acc;
+
+                if(!f(next)) {
+                    while(level > 0) {
+                        --level, r *= WIDTH;
+                        while(true) {
+                            const operand child = operand(this->_node(level, 0)[r - 1]) + acc;
+                            if(!f(child)) break;
+                            acc = child, --r;
+                        }
+                    }
+                    return r;
+                }
+
+                acc = next;
+            }
+
+            if(begin == 0) return 0;
+
+            r = begin / WIDTH, ++level;
+        }
+    }
+};
+
+
+} // namespace wide_segment_tree_impl
+
+} // namespace internal
+
+
+// A static-shape segment tree with `Width`-ary nodes, for `addition`, `minimum` and `maximum` over arithmetic types.
+template<class T, std::size_t Width = 0>
+struct wide_segment_tree : internal::unconstructible {};
+
+
+template<internal::wide_segment_tree_impl::vectorizable_monoid Monoid, std::size_t Width>
+struct wide_segment_tree<Monoid, Width> {
+  private:
+    static constexpr std::size_t WIDTH = Width > 0 ? Width : std::max<std::size_t>(64 / sizeof(typename Monoid::value_type), 8);
+
+    using core = typename internal::wide_segment_tree_impl::core<Monoid, WIDTH>;
+
+    core _impl;
+
+  public:
+    using value_type = Monoid;
+    using size_type = typename core::size_type;
+
+  private:
+    inline auto _positivize_index(const size_type p) const noexcept(NO_EXCEPT) {
+        return p < 0 ? this->_impl.size() + p : p;
+    }
+
+  public:
+    wide_segment_tree() noexcept(NO_EXCEPT) : _impl() {};
+    explicit wide_segment_tree(const size_type n, const value_type& v = value_type()) noexcept(NO_EXCEPT) : _impl(n) { this->_impl.fill(v); }
+
+    template<std::convertible_to<value_type> T>
+    wide_segment_tree(const std::initializer_list<T>& init_list) noexcept(NO_EXCEPT) : wide_segment_tree(ALL(init_list)) {}
+
+    template<std::input_iterator I, std::sized_sentinel_for<I> S>
+    wide_segment_tree(I first, S last) noexcept(NO_EXCEPT)
+      : _impl(static_cast<size_type>(std::ranges::distance(first, last)))
+    { this->assign(first, last); }
+
+    template<std::ranges::input_range R>
+    explicit wide_segment_tree(R&& range) noexcept(NO_EXCEPT) : wide_segment_tree(ALL(range)) {}
+
+
+    inline auto size() const noexcept(NO_EXCEPT) { return this->_impl.size(); }
+    inline auto allocated() const noexcept(NO_EXCEPT) { return this->_impl.allocated(); }
+    inline auto depth() const noexcept(NO_EXCEPT) { return this->_impl.depth(); }
+
+    inline auto _memory() const noexcept(NO_EXCEPT) { return this->_impl._memory(); }
+
+
+    template<std::convertible_to<value_type> T>
+    inline auto& assign(const std::initializer_list<T>& init_list) noexcept(NO_EXCEPT) { return this->assign(ALL(init_list)); }
+
+    template<std::input_iterator I, std::sentinel_for<I> S>
+    inline auto& assign(I first, S last) noexcept(NO_EXCEPT) {
+        this->_impl.assign(first, last);
+        return *this;
+    }
+
+    template<std::ranges::input_range R>
+    inline auto& assign(R&& range) noexcept(NO_EXCEPT) { return this->assign(ALL(range)); }
+
+    inline auto& fill(const value_type& v = value_type()) noexcept(NO_EXCEPT) {
+        this->_impl.fill(v);
+        return *this;
+    }
+
+    inline bool empty() const noexcept(NO_EXCEPT) { return this->_impl.size() == 0; }
+
+    struct point_reference : internal::point_reference<wide_segment_tree> {
+        point_reference(wide_segment_tree *const super, const size_type p) noexcept(NO_EXCEPT)
+          : internal::point_reference<wide_segment_tree>(super, super->_positivize_index(p))
+        {
+            assert(0 <= this->_pos && this->_pos < this->_super->size());
+        }
+
+        operator value_type() const noexcept(NO_EXCEPT) { return this->_super->get(this->_pos); }
+        auto val() const noexcept(NO_EXCEPT) { return this->_super->get(this->_pos); }
+
+        inline auto& operator=(const value_type& v) noexcept(NO_EXCEPT) {
+            this->_super->set(this->_pos, v);
+            return *this;
+        }
+
+        inline auto& operator+=(const value_type& v) noexcept(NO_EXCEPT) {
+            this->_super->add(this->_pos, v);
+            return *this;
+        }
+    };
+
+    struct range_reference : internal::range_reference<wide_segment_tree> {
+        range_reference(wide_segment_tree *const super, const size_type l, const size_type r) noexcept(NO_EXCEPT)
+          : internal::range_reference<wide_segment_tree>(super, super->_positivize_index(l), super->_positivize_index(r))
+        {
+            assert(0 <= this->_begin && this->_begin <= this->_end && this->_end <= this->_super->size());
+        }
+
+        inline auto fold() noexcept(NO_EXCEPT) {
+            if(this->_begin == 0 and this->_end == this->_super->size()) return this->_super->fold();
+            return this->_super->fold(this->_begin, this->_end);
+        }
+    };
+
+
+    inline auto& add(const size_type p, const value_type& x) noexcept(NO_EXCEPT) {
+        assert(0 <= p && p < this->_impl.size());
+        this->_impl.add(p, x);
+        return *this;
+    }
+
+    inline auto& set(const size_type p, const value_type& x) noexcept(NO_EXCEPT) {
+        assert(0 <= p && p < this->_impl.size());
+        this->_impl.set(p, x);
+        return *this;
+    }
+
+    inline auto get(const size_type p) const noexcept(NO_EXCEPT) {
+        assert(0 <= p && p < this->_impl.size());
+        return this->_impl.get(p);
+    }
+
+    inline auto operator[](const size_type p) noexcept(NO_EXCEPT) { return point_reference(this, p); }
+    inline auto operator()(const size_type l, const size_type r) noexcept(NO_EXCEPT) { return range_reference(this, l, r); }
+
+    inline auto fold(const size_type l, const size_type r) const noexcept(NO_EXCEPT) {
+        assert(0 <= l && l <= r && r <= this->_impl.size());
+        return this->_impl.fold(l, r);
+    }
+    inline auto fold(const size_type r) const noexcept(NO_EXCEPT) {
+        assert(0 <= r && r <= this->_impl.size());
+        return this->_impl.fold(0, r);
+    }
+    inline auto fold() const noexcept(NO_EXCEPT) {
+        return this->_impl.fold_all();
+    }
+
+
+    template<bool (*f)(value_type)>
+    inline auto max_right(const size_type l) const noexcept(NO_EXCEPT) {
+        return this->_impl.max_right(l, [](value_type x) { return f(x); });
+    }
+
+    template<class F>
+    inline auto max_right(const size_type l, F&& f) const noexcept(NO_EXCEPT) {
+        return this->_impl.max_right(l, std::forward<F>(f));
+    }
+
+
+    template<bool (*f)(value_type)>
+    inline auto min_left(const size_type r) const noexcept(NO_EXCEPT) {
+        return this->_impl.min_left(r, [](value_type x) { return f(x); });
+    }
+
+    template<class F>
+    inline auto min_left(const size_type r, F&& f) const noexcept(NO_EXCEPT) {
+        return this->_impl.min_left(r, std::forward<F>(f));
+    }
+
+
+    struct iterator;
+
+  protected:
+    using iterator_interface = internal::container_iterator_interface<value_type, const wide_segment_tree, iterator>;
+
+  public:
+    struct iterator : iterator_interface {
+        using iterator_interface::iterator_interface;
+    };
+
+    inline auto begin() const noexcept(NO_EXCEPT) { return iterator(this, 0); }
+    inline auto end() const noexcept(NO_EXCEPT) { return iterator(this, this->_impl.size()); }
+
+    inline auto rbegin() const noexcept(NO_EXCEPT) { return std::make_reverse_iterator(this->end()); }
+    inline auto rend() const noexcept(NO_EXCEPT) { return std::make_reverse_iterator(this->begin()); }
+};
+
+
+template<actions::internal::operatable_action Action, std::size_t Width>
+    requires internal::wide_segment_tree_impl::vectorizable_monoid<typename Action::operand>
+struct wide_segment_tree<Action, Width> : wide_segment_tree<typename Action::operand, Width> {
+    using wide_segment_tree<typename Action::operand, Width>::wide_segment_tree;
+};
+
+
+} // namespace uni
@@ -5,10 +5,14 @@
 #include <limits>
 #include <iterator>
 #include <string_view>
+#include <span>
 #include <sstream>
 #include <array>
 #include <string>
 #include <cstring>
+#include <charconv>
+#include <algorithm>
+#include <cstdint>
 #include <vector>
 #include <bitset>
 #include <deque>
@@ -18,11 +22,21 @@
 #include <unordered_set>
 #include <map>
 #include <unordered_map>
+#include <optional>
 #include <utility>
 #include <iomanip>
 #include <ranges>
 #include <concepts>
 #include <type_traits>
+#include <memory>
+#include <bit>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <csignal>
+
+#include <unistd.h>
 
 
 #include "numeric/int128.hpp"
@@ -33,6 +47,7 @@
 #include "internal/exception.hpp"
 
 #include <typeinfo>
+#include <typeindex>
 #include <cxxabi.h>
 
 
@@ -70,16 +85,17 @@ constexpr std::string COLOR_LITERAL_OPERATOR = "";
 
 #endif
 
-using Brackets = std::pair<std::string, std::string>;
+using Brackets = std::pair<std::string_view, std::string_view>;
+
 
+template<class T>
+void dump(std::string&, T&&);
 
 template<class T>
 std::string dump(T&&);
 
 
-template<class T>
-const std::string get_type_name(T&& val) {
-    const char* const name = typeid(std::forward<T>(val)).name();
+std::string demangle(const char* const name) {
     int status = -4;
     char* const demangled_name = abi::__cxa_demangle(name, NULL, NULL, &status);
     std::string res{name};
@@ -88,7 +104,31 @@ const std::string get_type_name(T&& val) {
         free(demangled_name);
     }
 
-    return COLOR_TYPE + res + COLOR_INIT;
+    return res;
+}
+
+// Demangling allocates, so each type is demangled only once.
+template<class T>
+const std::string& get_type_name(T&& val) {
+    using type = std::remove_cvref_t<T>;
+
+    if constexpr(std::is_polymorphic_v<type>) {
+        static std::unordered_map<std::type_index, std::string> cache;
+        static std::mutex mutex;
+
+        const std::type_index index = typeid(std::forward<T>(val));
+
+        const std::lock_guard lock(mutex);
+
+        auto found = cache.find(index);
+        if(found == cache.end()) found = cache.emplace(index, COLOR_TYPE + demangle(index.name()) + COLOR_INIT).first;
+
+        return found->second;
+    }
+    else {
+        static const std::string name = COLOR_TYPE + demangle(typeid(type).name()) + COLOR_INIT;
+        return name;
+    }
 }
 
 struct debug_t : std::string {
@@ -100,116 +140,279 @@ struct debug_t : std::string {
 
 
 template<size_t N, class T>
-void dump_tuple_impl([[maybe_unused]] T&& val, std::stringstream &res) {
+void dump_tuple_impl(std::string& res, [[maybe_unused]] T&& val) {
     if constexpr(N < std::tuple_size_v<std::remove_cvref_t<T>>) {
-        res << dump(std::get<N>(val));
-        if constexpr(N < std::tuple_size_v<std::remove_cvref_t<T>> - 1) res << ", ";
-        dump_tuple_impl<N + 1>(std::forward<T>(val), res);
+        dump(res, std::get<N>(val));
+        if constexpr(N < std::tuple_size_v<std::remove_cvref_t<T>> - 1) res += ", ";
+        dump_tuple_impl<N + 1>(res, std::forward<T>(val));
     }
 }
 
 
+// Bounds the work done by a single dump, so that tracing large inputs stays cheap.
+struct elision_policy {
+    // Ranges longer than `max_elements` only show their first `head` and last `tail` elements.
+    std::size_t max_elements = 256;
+    std::size_t head = 128, tail = 128;
+
+    // Ranges nested deeper than this are shown as `[ ... ]`.
+    std::size_t max_depth = 32;
+
+    // Longer strings are cut off.
+    std::size_t max_string_length = 4096;
+};
+
+elision_policy elision;
+
+
+constexpr std::string_view ELLIPSIS = "...";
+
+thread_local std::size_t depth = 0;
+
+struct nesting {
+    nesting() noexcept { ++depth; }
+    ~nesting() noexcept { --depth; }
+};
+
+
 template<std::ranges::input_range R>
-std::string dump_range_impl(R&& range, const Brackets& brcs = { "[", "]" }, const std::string& spl = ", ") {
-    std::stringstream res;
+void dump_range_impl(std::string& res, R&& range, const Brackets& brcs = { "[", "]" }, const std::string_view spl = ", ") {
+    res += brcs.first;
+    res += ' ';
+
+    if(depth >= elision.max_depth) {
+        res += ELLIPSIS;
+        res += ' ';
+        res += brcs.second;
+        return;
+    }
 
-    res << brcs.first << " ";
+    const nesting guard;
 
     auto itr = std::ranges::begin(range);
-    auto end = std::ranges::end(std::forward<R>(range));
+    const auto end = std::ranges::end(range);
+
+    bool empty = true;
+
+    const auto put = [&](auto&& v) {
+        if(!empty) res += spl;
+        dump(res, v);
+        empty = false;
+    };
+
+    const auto elide = [&]() {
+        if(!empty) res += spl;
+        res += ELLIPSIS;
+        empty = false;
+    };
+
+    if constexpr(std::ranges::sized_range<R> && std::ranges::forward_range<R>) {
+        const auto size = static_cast<std::size_t>(std::ranges::size(range));
+
+        if(size > elision.max_elements && elision.head + elision.tail < size) {
+            for(std::size_t i = 0; i < elision.head; ++i, ++itr) put(*itr);
+            elide();
+
+            if constexpr(std::ranges::bidirectional_range<R> && std::ranges::common_range<R>) {
+                itr = std::ranges::prev(end, elision.tail);
+            }
+            else {
+                std::ranges::advance(itr, size - elision.head - elision.tail);
+            }
+        }
+
+        for(; itr != end; ++itr) put(*itr);
+    }
+    else {
+        for(std::size_t i = 0; itr != end; ++i, ++itr) {
+            if(i == elision.max_elements) {
+                elide();
+                break;
+            }
+            put(*itr);
+        }
+    }
+
+    if(!empty) res += ' ';
+
+    res += brcs.second;
+}
+
+
+template<std::ranges::random_access_range S>
+void dump_string_impl(std::string& res, const S& str) {
+    const auto first = std::ranges::begin(str);
+
+    if(std::ranges::size(str) <= elision.max_string_length) {
+        res.append(first, std::ranges::end(str));
+        return;
+    }
+
+    res.append(first, std::ranges::next(first, elision.max_string_length));
+    res += ELLIPSIS;
+}
+
+
+void dump_debug_t(std::string& res, const debug_t& info) {
+    res += info;
+}
+
+
+// Enough for 128-bit integers and for `long double` at `digits10` significant digits.
+constexpr std::size_t NUMBER_BUFFER_SIZE = 64;
+
+template<class T>
+concept int128 = std::same_as<T, __int128_t> || std::same_as<T, __uint128_t>;
+
+// Writes `val` in decimal to `first`, 19 digits at a time, and returns the end of it.
+template<int128 T>
+char* int128_to_chars(char* first, char* const last, const T val) {
+    constexpr std::uint64_t CHUNK = 10'000'000'000'000'000'000ULL;
+    constexpr int CHUNK_DIGITS = 19;
+
+    __uint128_t abs = static_cast<__uint128_t>(val);
+    if constexpr(std::is_signed_v<T>) {
+        if(val < 0) {
+            *first++ = '-';
+            abs = -abs;
+        }
+    }
+
+    if(abs <= std::numeric_limits<std::uint64_t>::max()) {
+        return std::to_chars(first, last, static_cast<std::uint64_t>(abs)).ptr;
+    }
 
-    while(itr != end) {
-        if(std::ranges::next(itr) == end) res << dump(*itr) << " ";
-        else res << dump(*itr) << spl;
-        ++itr;
+    std::array<std::uint64_t, 3> chunks;
+    int count = 0;
+    while(abs > 0) {
+        chunks[count++] = static_cast<std::uint64_t>(abs % CHUNK);
+        abs /= CHUNK;
     }
 
-    res << brcs.second ;
+    first = std::to_chars(first, last, chunks[--count]).ptr;
+    while(count > 0) {
+        const auto chunk = chunks[--count];
+        const auto end = std::to_chars(first, last, chunk).ptr;
+        const auto digits = end - first;
+        std::memmove(first + (CHUNK_DIGITS - digits), first, static_cast<std::size_t>(digits));
+        std::fill(first, first + (CHUNK_DIGITS - digits), '0');
+        first += CHUNK_DIGITS;
+    }
 
-    return res.str();
+    return first;
 }
 
+// Formats `val` without allocating; floating-point values get `digits10` significant digits, as `std::setprecision` did.
+template<uni::internal::arithmetic T>
+char* format_number(char* const first, char* const last, const T val) {
+    if constexpr(int128<T>) {
+        return int128_to_chars(first, last, val);
+    }
+    else if constexpr(std::is_floating_point_v<T>) {
+        return std::to_chars(first, last, val, std::chars_format::general, std::numeric_limits<T>::digits10).ptr;
+    }
+    else {
+        return std::to_chars(first, last, val).ptr;
+    }
+}
 
-std::string dump_debug_t(debug_t info) {
-    return info;
+// Appends `str`, inserting thousands separators into the integral digits only.
+void append_grouped(std::string& res, std::string_view str) {
+    if(!str.empty() && str.front() == '-') {
+        res += '-';
+        str.remove_prefix(1);
+    }
+
+    const auto digits = std::min(str.find_first_not_of("0123456789"), str.size());
+
+    std::size_t head = digits == 0 ? 0 : (digits - 1) % 3 + 1;
+    res.append(str, 0, head);
+    for(; head < digits; head += 3) {
+        res += ',';
+        res.append(str, head, 3);
+    }
+
+    res.append(str, digits);
 }
 
 
 struct dump_primitive_like {
-    std::string operator()(std::nullptr_t) const {
-        return COLOR_INIT;
+    void operator()(std::string& res, std::nullptr_t) const {
+        res += COLOR_INIT;
     }
 
     template<uni::internal::pointer T>
-    std::string operator()(const T ptr) const {
-        return dump(*ptr);
+    void operator()(std::string& res, const T ptr) const {
+        dump(res, *ptr);
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::basic_string>
-    std::string operator()(T&& val) const {
-        std::stringstream res;
-        res << COLOR_STRING << "`" << val << "`" << COLOR_INIT;
-        return res.str();
+    void operator()(std::string& res, T&& val) const {
+        res += COLOR_STRING;
+        res += '`';
+        dump_string_impl(res, val);
+        res += '`';
+        res += COLOR_INIT;
     }
 
-    std::string operator()(const char val) const {
-        std::stringstream res;
-        res << COLOR_STRING << "\'" << val << "\'" << COLOR_INIT;
-        return res.str();
+    void operator()(std::string& res, const char val) const {
+        res += COLOR_STRING;
+        res += '\'';
+        res += val;
+        res += '\'';
+        res += COLOR_INIT;
     }
 
-    std::string operator()(const char val[]) const {
-        std::stringstream res;
-        res << COLOR_STRING << "\"" << val << "\"" <<  COLOR_INIT;
-        return res.str();
+    void operator()(std::string& res, const char val[]) const {
+        res += COLOR_STRING;
+        res += '\"';
+        dump_string_impl(res, std::string_view{ val });
+        res += '\"';
+        res += COLOR_INIT;
     }
 
-    std::string operator()(const unsigned char val) const {
-        std::stringstream res;
-        res << COLOR_NUMERIC << static_cast<int>(val) << COLOR_INIT;
-        return res.str();
+    void operator()(std::string& res, const unsigned char val) const {
+        res += COLOR_NUMERIC;
+        res += std::to_string(static_cast<int>(val));
+        res += COLOR_INIT;
     }
 
 
-    std::string operator()(const bool val) const {
-        std::stringstream res;
-        res << COLOR_NUMERIC << (val ? "true" : "false" ) << COLOR_INIT;
-        return res.str();
+    void operator()(std::string& res, const bool val) const {
+        res += COLOR_NUMERIC;
+        res += (val ? "true" : "false");
+        res += COLOR_INIT;
     }
 
 
     template<uni::internal::arithmetic T>
-    std::string operator()(const T val) const {
-        std::stringstream res;
-        res << std::setprecision(std::numeric_limits<T>::digits10) << val;
-
-        auto str = res.str();
-
-        std::string dst = "";
-        while(str.length() > 3) {
-            dst = ',' + str.substr(str.length() - 3, 3) + dst;
-            str = str.substr(0, str.length() - 3);
-        }
-
-        return COLOR_NUMERIC + str + dst + COLOR_LITERAL_OPERATOR + uni::internal::literal_operator_v<T> + COLOR_INIT;
+    void operator()(std::string& res, const T val) const {
+        std::array<char, NUMBER_BUFFER_SIZE> buffer;
+        const std::string_view str(buffer.data(), format_number(buffer.data(), buffer.data() + buffer.size(), val));
+
+        res += COLOR_NUMERIC;
+        append_grouped(res, str);
+        res += COLOR_LITERAL_OPERATOR;
+        res += uni::internal::literal_operator_v<T>;
+        res += COLOR_INIT;
     };
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::optional>
-    std::string operator()(T&& val) const {
-        if(val.has_value()) return dump(*val);
-        return COLOR_TYPE + "invalid" + COLOR_INIT;
+    void operator()(std::string& res, T&& val) const {
+        if(val.has_value()) return dump(res, *val);
+        res += COLOR_TYPE + "invalid" + COLOR_INIT;
     }
 };
 
 
 struct dump_bitset {
     template<std::size_t N>
-    std::string operator()(const std::bitset<N>& val) const {
-        std::stringstream res;
-        res << COLOR_NUMERIC << val.to_string() << COLOR_INIT;
-        return res.str();
+    void operator()(std::string& res, const std::bitset<N>& val) const {
+        res += COLOR_NUMERIC;
+        for(std::size_t i = N; i-- > 0;) res += (val[i] ? '1' : '0');
+        res += COLOR_INIT;
     }
 };
 
@@ -217,305 +420,948 @@ struct dump_bitset {
 struct dump_has_val {
     template<class T>
         requires requires (T val) { val.val(); }
-    std::string operator()(T&& val) const {
-        return dump(val.val());
+    void operator()(std::string& res, T&& val) const {
+        dump(res, val.val());
     }
 };
 
 
 struct dump_iterator {
     template<std::input_or_output_iterator I>
-    std::string operator()(I&& itr) const {
-        return COLOR_TYPE + "<iterator> " + COLOR_INIT+ dump(*itr);
+    void operator()(std::string& res, I&& itr) const {
+        res += COLOR_TYPE + "<iterator> " + COLOR_INIT;
+        dump(res, *itr);
     }
 };
 
 
+// Exposes the underlying container of std::queue, std::stack and std::priority_queue without copying them.
+template<class T>
+struct adaptor_access : T {
+    static const auto& container(const T& val) { return val.*(&adaptor_access::c); }
+    static const auto& compare(const T& val) { return val.*(&adaptor_access::comp); }
+};
+
+
 struct dump_wrapper {
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::map>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::multimap>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::unordered_map>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::unordered_multimap>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::set>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::multiset>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::unordered_set>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::unordered_multiset>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("{", "}"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("{", "}"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::valarray>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("[", "]"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("[", "]"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::vector>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("[", "]"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("[", "]"));
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::deque>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val, Brackets("[", "]"));
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val, Brackets("[", "]"));
     }
 
 
     template<uni::internal::derived_from_template<std::queue> T>
-    std::string operator()(T val) const {
-        std::vector<typename T::value_type> vec;
-
-        while(!val.empty()) vec.emplace_back(val.front()), val.pop();
-
-        return dump_range_impl(vec, Brackets("<", ">"));
+    void operator()(std::string& res, const T& val) const {
+        dump_range_impl(res, adaptor_access<T>::container(val), Brackets("<", ">"));
     }
 
     template<uni::internal::derived_from_template<std::stack> T>
-    std::string operator()(T val) const {
-        std::vector<typename T::value_type> vec;
-
-        while(!val.empty()) vec.emplace_back(val.top()), val.pop();
-        std::ranges::reverse(vec);
-
-        return dump_range_impl(vec, Brackets("<", ">"));
+    void operator()(std::string& res, const T& val) const {
+        dump_range_impl(res, adaptor_access<T>::container(val), Brackets("<", ">"));
     }
 
     template<uni::internal::derived_from_template<std::priority_queue> T>
-    std::string operator()(T val) const {
-        std::vector<typename T::value_type> vec;
+    void operator()(std::string& res, const T& val) const {
+        const auto& container = adaptor_access<T>::container(val);
+
+        // Shown as `< ... >` without looking at the elements.
+        if(depth >= elision.max_depth) return dump_range_impl(res, container, Brackets("<", ">"));
+
+        const auto size = static_cast<std::size_t>(std::ranges::size(container));
+
+        const auto& comp = adaptor_access<T>::compare(val);
+        const auto order = [&](const auto& lhs, const auto& rhs) { return comp(rhs, lhs); };
+
+        // Every element is shown, so copying them costs no more than printing them.
+        if(size <= elision.max_elements || elision.head + elision.tail >= size) {
+            std::vector<typename T::value_type> vec(std::ranges::begin(container), std::ranges::end(container));
+            std::ranges::sort(vec, order);
+            dump_range_impl(res, vec, Brackets("<", ">"));
+            return;
+        }
 
-        while(!val.empty()) vec.emplace_back(val.top()), val.pop();
+        // Only the elements actually shown are selected, in popping order, without copying the others.
+        using pointer = const typename T::value_type*;
+        const auto address = [](const auto& v) { return std::addressof(v); };
+        const auto deref = [](const pointer p) -> const auto& { return *p; };
 
-        return dump_range_impl(vec, Brackets("<", ">"));
+        std::vector<pointer> head(elision.head), tail(elision.tail);
+        std::ranges::partial_sort_copy(container | std::views::transform(address), head, order, deref, deref);
+        std::ranges::partial_sort_copy(container | std::views::transform(address), tail, comp, deref, deref);
+        std::ranges::reverse(tail);
+
+        res += "< ";
+        {
+            const nesting guard;
+
+            for(const auto p : head) dump(res, *p), res += ", ";
+            res += ELLIPSIS;
+            for(const auto p : tail) res += ", ", dump(res, *p);
+        }
+        res += " >";
     }
 
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::pair>
-    std::string operator()(T&& val) const {
-        std::stringstream res;
-        res << "( " << dump(val.first) << ", " << dump(val.second) << " )";
-        return res.str();
+    void operator()(std::string& res, T&& val) const {
+        res += "( ";
+        dump(res, val.first);
+        res += ", ";
+        dump(res, val.second);
+        res += " )";
     }
 
     template<class T>
         requires uni::internal::derived_from_template<std::remove_cvref_t<T>, std::tuple>
-    std::string operator()(T&& val) const {
-        std::stringstream res;
-        res << "( ";
-        dump_tuple_impl<0>(val, res);
-        res << " )";
-        return res.str();
+    void operator()(std::string& res, T&& val) const {
+        res += "( ";
+        dump_tuple_impl<0>(res, val);
+        res += " )";
     }
 };
 
 
 struct dump_range {
     template<std::ranges::input_range T>
-    std::string operator()(T&& val) const {
-        return dump_range_impl(val);
+    void operator()(std::string& res, T&& val) const {
+        dump_range_impl(res, val);
     }
 };
 
 
 struct dump_loggable {
     template<uni::internal::loggable T>
-    std::string operator()(T&& val) const {
-        auto res = _debug(val);
+    void operator()(std::string& res, T&& val) const {
+        auto&& log = _debug(val);
 
-        if constexpr(std::same_as<decltype(res), debug_t>) {
-            return res;
+        if constexpr(std::same_as<std::remove_cvref_t<decltype(log)>, debug_t>) {
+            res += log;
         }
         else {
-            return dump(res);
+            dump(res, log);
         }
     }
 };
 
 
 template<class T>
-std::string dump(T&& val) {
+void dump(std::string& res, T&& val) {
     if constexpr(std::same_as<std::remove_cvref_t<T>, debug_t>) {
         // return "debug_t";
-        return dump_debug_t(std::forward<T>(val));
+        return dump_debug_t(res, std::forward<T>(val));
     }
 
-    if constexpr(std::invocable<dump_primitive_like, T>) {
+    if constexpr(std::invocable<dump_primitive_like, std::string&, T>) {
         // return "primitive";
-        return dump_primitive_like{}(std::forward<T>(val));
+        return dump_primitive_like{}(res, std::forward<T>(val));
     }
-    if constexpr(std::invocable<dump_loggable, T>) {
+    if constexpr(std::invocable<dump_loggable, std::string&, T>) {
         // return "loggable";
-        return dump_loggable{}(std::forward<T>(val));
+        return dump_loggable{}(res, std::forward<T>(val));
     }
-    if constexpr(std::invocable<dump_has_val, T>) {
+    if constexpr(std::invocable<dump_has_val, std::string&, T>) {
         // return "has val";
-        return dump_has_val{}(std::forward<T>(val));
+        return dump_has_val{}(res, std::forward<T>(val));
     }
 
-    if constexpr(std::invocable<dump_bitset, T>) {
+    if constexpr(std::invocable<dump_bitset, std::string&, T>) {
         // return "bitset";
-        return dump_bitset{}(std::forward<T>(val));
+        return dump_bitset{}(res, std::forward<T>(val));
     }
-    if constexpr(std::invocable<dump_iterator, T>) {
+    if constexpr(std::invocable<dump_iterator, std::string&, T>) {
         // return "iterator";
-        return dump_iterator{}(std::forward<T>(val));
+        return dump_iterator{}(res, std::forward<T>(val));
     }
 
-    if constexpr(std::invocable<dump_wrapper, T>) {
+    if constexpr(std::invocable<dump_wrapper, std::string&, T>) {
         // return "wrapper";
-        return dump_wrapper{}(std::forward<T>(val));
+        return dump_wrapper{}(res, std::forward<T>(val));
     }
 
-    if constexpr(std::invocable<dump_range, T>) {;
+    if constexpr(std::invocable<dump_range, std::string&, T>) {;
         // return "range";
-        return dump_range{}(std::forward<T>(val));
+        return dump_range{}(res, std::forward<T>(val));
     }
 
-    return "== dump error ==";
+    res += "== dump error ==";
 }
 
 
-template<class T> void debug(T&& val, const std::string& endl) {
-    *cdebug << dump(val) << endl << std::flush;
+template<class T>
+std::string dump(T&& val) {
+    std::string res;
+    dump(res, std::forward<T>(val));
+    return res;
 }
 
 
-constexpr std::string_view WHITESPACES = " \n\r\t\f\v";
+std::mutex output_mutex;
 
-std::string ltrim(const std::string &s)
-{
-    size_t start = s.find_first_not_of(WHITESPACES);
-    return (start == std::string::npos) ? "" : s.substr(start);
+// Each call writes out a whole record, so records from different threads never interleave.
+void write(const std::string_view str) {
+    const std::lock_guard lock(output_mutex);
+    cdebug->write(str.data(), static_cast<std::streamsize>(str.size()));
+    *cdebug << std::flush;
 }
 
-std::string rtrim(const std::string &s)
-{
-    size_t end = s.find_last_not_of(WHITESPACES);
-    return (end == std::string::npos) ? "" : s.substr(0, end + 1);
+
+#ifdef DEBUGGER_ASYNC_OUTPUT
+
+#ifndef DEBUGGER_ASYNC_BUFFER_SIZE
+#define DEBUGGER_ASYNC_BUFFER_SIZE (1UL << 24)
+#endif
+
+// Drained to `cdebug` by a background thread. Each producing thread owns a single-producer ring and pushes into it without locking;
+// the worker switches rings only between whole records, so that records from different threads never interleave.
+struct async_sink {
+    static constexpr std::size_t CAPACITY = DEBUGGER_ASYNC_BUFFER_SIZE;
+    static_assert(std::has_single_bit(CAPACITY));
+
+    static constexpr std::chrono::microseconds NAP{ 500 };
+
+  private:
+    struct ring {
+        std::unique_ptr<char[]> data{ new char[CAPACITY] };
+
+        std::atomic<std::size_t> head = 0, tail = 0;
+
+        // The end of the last complete record.
+        std::atomic<std::size_t> boundary = 0;
+
+        // Released when the owning thread exits, and handed to the next thread that asks for one.
+        std::atomic<bool> owned = true;
+
+        ring* next = nullptr;
+    };
+
+    // Only ever grows, so that the signal handler can walk it without locking.
+    std::atomic<ring*> _rings = nullptr;
+
+    // Waited on by the idle worker; bumped only when it has announced through `_sleeping`, so that pushes make no system call while it is awake.
+    std::atomic<std::uint32_t> _signal = 0;
+    std::atomic<bool> _sleeping = false;
+
+    std::atomic<bool> _running = true;
+
+    void (*_previous)(int) = SIG_DFL;
+
+    std::thread _worker;
+
+
+    // Called after a sequentially consistent store to a ring, which `_sleep()` pairs with.
+    void _notify() {
+        if(!this->_sleeping.load(std::memory_order_seq_cst)) return;
+
+        this->_signal.fetch_add(1, std::memory_order_release);
+        this->_signal.notify_one();
+    }
+
+    // Blocks until a push, unless `ready()` already holds once the producers can see that the worker is asleep.
+    // Either `ready()` sees the store of a producer, or that producer sees `_sleeping`; both sides are sequentially consistent for this.
+    template<class F>
+    void _sleep(F&& ready) {
+        const auto signal = this->_signal.load(std::memory_order_acquire);
+
+        this->_sleeping.store(true, std::memory_order_seq_cst);
+        if(!ready()) this->_signal.wait(signal, std::memory_order_acquire);
+        this->_sleeping.store(false, std::memory_order_relaxed);
+    }
+
+    ring& _ring() {
+        thread_local ring* mine = nullptr;
+        thread_local bool exited = false;
+
+        if(mine != nullptr) return *mine;
+
+        for(auto* r = this->_rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            bool expected = false;
+            if(r->owned.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+                mine = r;
+                break;
+            }
+        }
+
+        if(mine == nullptr) {
+            mine = new ring;
+            mine->next = this->_rings.load(std::memory_order_relaxed);
+            while(!this->_rings.compare_exchange_weak(mine->next, mine, std::memory_order_release, std::memory_order_relaxed));
+        }
+
+        // Not re-armed once this thread has started tearing down its locals; the ring is then kept until exit.
+        if(!exited) {
+            struct releaser {
+                ~releaser() {
+                    if(mine != nullptr) mine->owned.store(false, std::memory_order_release);
+                    mine = nullptr, exited = true;
+                }
+            };
+            thread_local releaser release;
+            (void)release;
+        }
+
+        return *mine;
+    }
+
+    // Writes out `[tail, head)` of `r`; a record cut off by a full ring is waited for, and written out up to its end.
+    bool _drain(ring& r) {
+        auto tail = r.tail.load(std::memory_order_relaxed);
+        if(tail == r.head.load(std::memory_order_acquire)) return false;
+
+        while(true) {
+            const auto head = r.head.load(std::memory_order_acquire);
+
+            while(tail != head) {
+                const auto size = std::min(head - tail, CAPACITY - (tail & (CAPACITY - 1)));
+                cdebug->write(r.data.get() + (tail & (CAPACITY - 1)), static_cast<std::streamsize>(size));
+                tail += size;
+            }
+
+            r.tail.store(tail, std::memory_order_release);
+            r.tail.notify_one();
+
+            if(tail == r.boundary.load(std::memory_order_acquire)) return true;
+            this->_sleep([&] { return tail != r.head.load(std::memory_order_seq_cst) or tail == r.boundary.load(std::memory_order_seq_cst); });
+        }
+    }
+
+    bool _pending() const {
+        for(auto* r = this->_rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+            if(r->tail.load(std::memory_order_relaxed) != r->head.load(std::memory_order_seq_cst)) return true;
+        }
+        return false;
+    }
+
+    bool _drain_all() {
+        bool wrote = false;
+        for(auto* r = this->_rings.load(std::memory_order_acquire); r != nullptr; r = r->next) wrote |= this->_drain(*r);
+
+        if(wrote) *cdebug << std::flush;
+        return wrote;
+    }
+
+    void _run() {
+        while(true) {
+            const bool running = this->_running.load(std::memory_order_acquire);
+
+            // While records keep coming, they are taken in batches, without waking up for each of them.
+            if(this->_drain_all()) {
+                if(running) std::this_thread::sleep_for(NAP);
+                continue;
+            }
+            if(!running) break;
+
+            this->_sleep([this] { return !this->_running.load(std::memory_order_relaxed) or this->_pending(); });
+        }
+    }
+
+    static void _on_abort(int);
+
+  public:
+    async_sink() : _worker([this] { this->_run(); }) {
+        this->_previous = std::signal(SIGABRT, &async_sink::_on_abort);
+    }
+
+    ~async_sink() {
+        this->stop();
+
+        for(auto* r = this->_rings.exchange(nullptr); r != nullptr; ) delete std::exchange(r, r->next);
+    }
+
+    void push(std::string_view str) {
+        if(!this->_running.load(std::memory_order_acquire)) return write(str);
+
+        ring& r = this->_ring();
+        auto head = r.head.load(std::memory_order_relaxed);
+
+        while(!str.empty()) {
+            const auto tail = r.tail.load(std::memory_order_acquire);
+            const auto available = CAPACITY - (head - tail);
+
+            if(available == 0) {
+                r.tail.wait(tail, std::memory_order_acquire);
+                continue;
+            }
+
+            const auto size = std::min({ available, str.size(), CAPACITY - (head & (CAPACITY - 1)) });
+            std::memcpy(r.data.get() + (head & (CAPACITY - 1)), str.data(), size);
+            head += size;
+            str.remove_prefix(size);
+
+            r.head.store(head, std::memory_order_seq_cst);
+            if(!str.empty()) this->_notify();
+        }
+
+        r.boundary.store(head, std::memory_order_seq_cst);
+        this->_notify();
+    }
+
+    // Drains the pending records and stops the worker; later records are written synchronously.
+    void stop() {
+        if(!this->_running.exchange(false)) return;
+
+        this->_signal.fetch_add(1, std::memory_order_release);
+        this->_signal.notify_one();
+
+        if(this->_worker.joinable() and this->_worker.get_id() != std::this_thread::get_id()) this->_worker.join();
+
+        this->_drain_all();
+    }
+};
+
+async_sink sink;
+
+// Only async-signal-safe calls here: what is left in the rings goes straight to `stderr` by `::write`, then the previous handler runs.
+// A piece that the worker is writing at the same moment may appear twice.
+void async_sink::_on_abort(const int sig) {
+    for(auto* r = sink._rings.load(std::memory_order_acquire); r != nullptr; r = r->next) {
+        auto tail = r->tail.load(std::memory_order_acquire);
+        const auto head = r->head.load(std::memory_order_acquire);
+
+        while(tail != head) {
+            const auto size = std::min(head - tail, CAPACITY - (tail & (CAPACITY - 1)));
+            const auto written = ::write(STDERR_FILENO, r->data.get() + (tail & (CAPACITY - 1)), size);
+            if(written <= 0) break;
+            tail += static_cast<std::size_t>(written);
+        }
+    }
+
+    if(sink._previous != SIG_DFL and sink._previous != SIG_IGN and sink._previous != SIG_ERR) sink._previous(sig);
 }
 
-std::string trim(const std::string &s) {
-    return rtrim(ltrim(s));
+#endif
+
+
+// Reused across calls, so that tracing does not allocate once its capacity is warmed up.
+// A record is assembled here and handed to the output in one piece.
+thread_local std::string buffer;
+
+// Hands a complete record to the output.
+void emit(const std::string_view str) {
+#ifdef DEBUGGER_ASYNC_OUTPUT
+    sink.push(str);
+#else
+    write(str);
+#endif
 }
 
-std::vector<std::string> split(const std::string& str) {
-    static constexpr char SEPARATOR = ',';
-    static constexpr char ESCAPE = '\\';
-    static constexpr std::string_view QUOTATIONS = "\"\'";
-    static constexpr std::string_view PARENTHESES = "()[]{}<>";
-    static constexpr auto PARENTHESES_KINDS = std::ranges::size(PARENTHESES);
-    static_assert(PARENTHESES_KINDS % 2 == 0);
+void flush_buffer() {
+    emit(buffer);
+    buffer.clear();
+}
 
-    std::vector<std::string> res = { "" };
+
+template<class T> void debug(T&& val, const std::string& endl) {
+    dump(buffer, val);
+    buffer += endl;
+    flush_buffer();
+}
+
+
+constexpr std::string_view WHITESPACES = " \n\r\t\f\v";
+
+constexpr std::string_view trim(const std::string_view str) {
+    const auto start = str.find_first_not_of(WHITESPACES);
+    if(start == std::string_view::npos) return "";
+    return str.substr(start, str.find_last_not_of(WHITESPACES) - start + 1);
+}
+
+
+// Calls `f` with each (trimmed) top-level, comma-separated piece of `str`.
+template<class F>
+constexpr void split(const std::string_view str, F&& f) {
+    constexpr char SEPARATOR = ',';
+    constexpr char ESCAPE = '\\';
+    constexpr std::string_view QUOTATIONS = "\"\'";
+    constexpr std::string_view PARENTHESES = "()[]{}<>";
+    constexpr auto PARENTHESES_KINDS = std::ranges::size(PARENTHESES);
+    static_assert(PARENTHESES_KINDS % 2 == 0);
 
     bool quoted = false;
     std::array<int,(PARENTHESES_KINDS / 2)> enclosed = { 0 };
 
-    for(auto itr = std::ranges::begin(str); itr != std::ranges::end(str); ++itr) {
-        if(std::ranges::find(QUOTATIONS, *itr) != std::ranges::end(QUOTATIONS)) {
-            if(itr == std::ranges::begin(str) or *std::ranges::prev(itr) != ESCAPE) {
+    std::size_t start = 0;
+
+    for(std::size_t i = 0; i < str.size(); ++i) {
+        if(QUOTATIONS.find(str[i]) != std::string_view::npos) {
+            if(i == 0 or str[i - 1] != ESCAPE) {
                 quoted ^= true;
             }
         }
 
-        if(const auto found = std::ranges::find(PARENTHESES, *itr); found != std::ranges::end(PARENTHESES)) {
+        if(const auto found = PARENTHESES.find(str[i]); found != std::string_view::npos) {
             if(not quoted) {
-                auto& target = enclosed[std::ranges::distance(std::begin(PARENTHESES), found) / 2];
-                target = std::max(0, target - static_cast<int>((std::ranges::distance(std::begin(PARENTHESES), found) % 2) * 2) + 1);
-
+                auto& target = enclosed[found / 2];
+                target = std::max(0, target - static_cast<int>((found % 2) * 2) + 1);
             }
         }
 
         if(
             not quoted
             and static_cast<std::size_t>(std::ranges::count(enclosed, 0)) == std::ranges::size(enclosed)
-            and *itr == SEPARATOR
+            and str[i] == SEPARATOR
         ) {
-            res.push_back("");
-        }
-        else {
-            res.back() += *itr;
+            f(trim(str.substr(start, i - start)));
+            start = i + 1;
         }
     }
 
-    for(auto&& v : res) v = trim(v);
+    f(trim(str.substr(start)));
+}
+
+consteval std::size_t count_arguments(const std::string_view str) {
+    std::size_t res = 0;
+    split(str, [&](std::string_view) { ++res; });
+    return res;
+}
 
+// Evaluated at compile time, so that `debug(...)` only pays for formatting the values.
+template<std::size_t N>
+consteval std::array<std::string_view, N> split(const std::string_view str) {
+    std::array<std::string_view, N> res;
+    std::size_t index = 0;
+    split(str, [&](const std::string_view arg) { res[index++] = arg; });
     return res;
 }
 
-template<class Arg> void raw(std::nullptr_t, Arg&& arg) { *cdebug << std::forward<Arg>(arg) << std::flush; }
-template<class Arg> void raw(Arg&& arg) { *cdebug << dump(std::forward<Arg>(arg)) << std::flush; }
+// Appended to the pending record; `debug_(...)` flushes it once the line is complete.
+template<class Arg> void raw(std::nullptr_t, Arg&& arg) { buffer += std::forward<Arg>(arg); }
+template<class Arg> void raw(Arg&& arg) { dump(buffer, std::forward<Arg>(arg)); }
+
+
+const std::thread::id main_thread = std::this_thread::get_id();
+std::atomic<std::size_t> threads = 0;
+
+// 0 for the main thread, and 1, 2, ... for the others in the order of their first record.
+std::size_t thread_index() {
+    thread_local const std::size_t index = std::this_thread::get_id() == main_thread ? 0 : ++threads;
+    return index;
+}
+
+// Index of the hit that the current thread is printing.
+thread_local std::size_t current_hit = 0;
+
+
+// Hit counter of a single `debug(...)` expansion.
+struct call_site {
+    std::atomic<std::size_t> hits = 0;
+
+    // Records printed within the current one-second window (see `sampling::rate`).
+    std::atomic<std::size_t> emitted = 0;
+    std::atomic<std::chrono::steady_clock::rep> window = 0;
+
+#ifdef DEBUGGER_BINARY_TRACE
+    // Assigned when the site is first written to the trace.
+    std::uint32_t trace_id = 0;
+#endif
+
+    // Counts a hit, and returns whether `sampler` lets it be printed.
+    template<class Sampler>
+    bool operator()(Sampler&& sampler) {
+        const auto hit = this->hits.fetch_add(1, std::memory_order_relaxed);
+        if(!sampler(*this, hit)) return false;
+        current_hit = hit;
+        return true;
+    }
+};
+
+// One counter per macro expansion; `ID` is supplied by `__COUNTER__`.
+template<std::size_t ID>
+call_site site;
+
+
+namespace sampling {
+
+
+struct always {
+    constexpr bool operator()(const call_site&, std::size_t) const noexcept { return true; }
+};
+
+// Prints every `n`-th hit, starting from the first one.
+struct every {
+    std::size_t n;
+    bool operator()(const call_site&, const std::size_t hit) const noexcept { return hit % this->n == 0; }
+};
+
+// Prints the first `k` hits only.
+struct first {
+    std::size_t k;
+    bool operator()(const call_site&, const std::size_t hit) const noexcept { return hit < this->k; }
+};
+
+// Prints at most `m` records per second.
+struct rate {
+    std::size_t m;
+
+    // Approximate under contention: a hit racing with the start of a new window may be counted in either.
+    bool operator()(call_site& site, std::size_t) const noexcept {
+        constexpr auto WINDOW = std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::seconds(1)).count();
+
+        const auto now = std::chrono::steady_clock::now().time_since_epoch().count();
+
+        auto window = site.window.load(std::memory_order_relaxed);
+        if(now - window >= WINDOW and site.window.compare_exchange_strong(window, now, std::memory_order_relaxed)) {
+            site.emitted.store(0, std::memory_order_relaxed);
+        }
+
+        return site.emitted.fetch_add(1, std::memory_order_relaxed) < this->m;
+    }
+};
+
+
+} // namespace sampling
+
+
+// The pieces of a `debug(...)` record, shared with the trace renderer.
+// They are appended to `buffer`, and `put_footer()` writes out the whole record.
+void put_header(const std::string_view path, const int line, const std::size_t hit, const std::size_t thread = 0) {
+    dump(buffer, nullptr);
+    buffer += COLOR_LINE;
+    buffer += path.substr(path.find_last_of('/') + 1);
+    buffer += " #";
+    buffer += std::to_string(line);
+    buffer += " (";
+    buffer += std::to_string(hit);
+    buffer += ")";
+    if(thread > 0) {
+        buffer += " [thread ";
+        buffer += std::to_string(thread);
+        buffer += "]";
+    }
+    buffer += COLOR_INIT;
+}
+
+void put_name(const std::string_view name) {
+    dump(buffer, nullptr);
+    buffer += "\n - ";
+
+    dump(buffer, nullptr);
+    buffer += COLOR_IDENTIFIER;
+    buffer += name;
+    buffer += COLOR_INIT;
+    buffer += " : ";
+}
+
+// Returns the length of the dumped content.
+template<class T>
+std::size_t put_value(T&& val) {
+    dump(buffer, nullptr);
+    const auto offset = buffer.size();
+    dump(buffer, std::forward<T>(val));
+    const auto content_size = buffer.size() - offset;
 
-void debug(const std::vector<std::string>, const size_t, const int, const std::string) { debug(nullptr, COLOR_INIT + "\n"); }
+    return content_size;
+}
 
+void put_type(const std::string_view type_name, const std::size_t content_size) {
+    if(type_name.size() + content_size >= 300) {
+        dump(buffer, nullptr);
+        buffer += "\n   ";
+    }
+
+    dump(buffer, nullptr);
+    buffer += ' ';
+    buffer += type_name;
+}
+
+void put_footer() { debug(nullptr, COLOR_INIT + "\n"); }
+
+
+#if !defined(DEBUGGER_BINARY_TRACE) && !defined(DEBUGGER_JSON_OUTPUT)
+
+void debug(const call_site&, const std::span<const std::string_view>, const size_t, const int, const std::string_view) { put_footer(); }
 
-std::map<std::pair<std::string, int>, int> count;
 
 template<class Head, class... Tail>
 void debug(
-    const std::vector<std::string> args, const size_t idx,
-    const int line, const std::string path,
+    const call_site& site,
+    const std::span<const std::string_view> args, const size_t idx,
+    const int line, const std::string_view path,
     Head&& H, Tail&&... T
 ) {
-    if(idx == 0) {
-        std::string file = path.substr(path.find_last_of("/") + 1);
-        debug(nullptr, COLOR_LINE + file + " #" + std::to_string(line) + " (" + std::to_string(count[{ file, line }]++) + ")" + COLOR_INIT);
+    if(idx == 0) put_header(path, line, current_hit, thread_index());
+
+    put_name(idx < args.size() ? args[idx] : "");
+
+    const auto content_size = put_value(H);
+
+    put_type(get_type_name(std::forward<Head>(H)), content_size);
+
+    debug(site, args, idx + 1, 0, path, std::forward<Tail>(T)...);
+}
+
+#endif
+
+
+// The value last passed to `debug_diff(...)`, per call site, argument and type.
+template<std::size_t ID, std::size_t I, class T>
+std::optional<T> snapshot;
+
+// Guards the snapshots of a `debug_diff(...)` call site.
+template<std::size_t ID>
+std::mutex snapshot_mutex;
+
+
+template<class T>
+concept indexable =
+    std::ranges::random_access_range<const T> && std::ranges::sized_range<const T> &&
+    !uni::internal::derived_from_template<T, std::basic_string>;
+
+template<class T>
+concept diffed_through_debug =
+    uni::internal::loggable<T> &&
+    !std::same_as<std::remove_cvref_t<decltype(_debug(std::declval<T&>()))>, debug_t>;
+
+// Values with a `_debug()` hook are compared through it, and other ranges element by element.
+template<class T>
+decltype(auto) diff_target(T&& val) {
+    using type = std::remove_cvref_t<T>;
+
+    if constexpr(diffed_through_debug<T>) {
+        return _debug(val);
+    }
+    else if constexpr(std::ranges::input_range<T> && !indexable<type> && !uni::internal::derived_from_template<type, std::basic_string>) {
+        return std::vector<std::ranges::range_value_t<T>>(std::ranges::begin(val), std::ranges::end(val));
+    }
+    else {
+        return std::forward<T>(val);
     }
-    debug(nullptr, "\n - ");
+}
 
 
-    const std::string content = dump(H);
-    const std::string type_name = get_type_name(std::forward<Head>(H));
+// Spells out what `differ` finds as text, e.g. `{ [1][2]: 0 -> 3, [4]: -> 5 }`.
+struct diff_text {
+    template<class T>
+    static void initial(std::string& res, const T& val) { dump(res, val); }
 
+    static void begin(std::string& res) { res += "{ "; }
+    static void end(std::string& res, const std::size_t) { res += " }"; }
 
-    debug(nullptr, COLOR_IDENTIFIER + args[idx]  + COLOR_INIT + " : ");
-    debug(nullptr, content);
+    // Marks the entries beyond the elision limit.
+    static void elide(std::string& res, const std::size_t entries) {
+        if(entries > 0) res += ", ";
+        res += ELLIPSIS;
+    }
 
-    if(type_name.size() + content.size() >= 300) debug(nullptr, "\n   ");
+    static void entry(std::string& res, const std::span<const std::size_t> path, const std::size_t index) {
+        if(index > 0) res += ", ";
+        if(!path.empty()) {
+            for(const auto i : path) res += '[', res += std::to_string(i), res += ']';
+            res += ": ";
+        }
+    }
 
-    debug(nullptr, " " + type_name);
+    template<class T>
+    static void removed(std::string& res, const T& prev) { dump(res, prev), res += " ->"; }
+
+    template<class T>
+    static void added(std::string& res, const T& curr) { res += "-> ", dump(res, curr); }
+
+    template<class T>
+    static void changed(std::string& res, const T& prev, const T& curr) {
+        dump(res, prev);
+        res += " -> ";
+        dump(res, curr);
+    }
+};
+
+
+// Lists the elements that differ between two values, in the notation of `Format`.
+template<class Format>
+struct differ {
+    std::string& res;
+    std::size_t entries = 0;
+
+    // The indices leading to the current element; spelled out only for the entries that are printed.
+    std::vector<std::size_t> path = {};
+
+    // Starts a new entry, and returns whether it is within the elision limit.
+    bool open() {
+        if(this->entries == elision.max_elements) Format::elide(res, this->entries);
+        if(this->entries++ >= elision.max_elements) return false;
+
+        Format::entry(res, this->path, this->entries - 1);
+        return true;
+    }
 
-    debug(args, idx + 1, 0, path, std::forward<Tail>(T)...);
+    template<class T>
+    void operator()(const T& prev, const T& curr) {
+        if constexpr(indexable<T>) {
+            const auto n = static_cast<std::size_t>(std::ranges::size(prev));
+            const auto m = static_cast<std::size_t>(std::ranges::size(curr));
+            const auto prev_begin = std::ranges::begin(prev);
+            const auto curr_begin = std::ranges::begin(curr);
+
+            this->path.push_back(0);
+
+            for(std::size_t i = 0; i < std::max(n, m); ++i) {
+                this->path.back() = i;
+
+                if(i < n and i < m) {
+                    (*this)(prev_begin[i], curr_begin[i]);
+                }
+                else if(i < n) {
+                    if(this->open()) Format::removed(res, prev_begin[i]);
+                }
+                else {
+                    if(this->open()) Format::added(res, curr_begin[i]);
+                }
+            }
+
+            this->path.pop_back();
+        }
+        else {
+            if constexpr(std::equality_comparable<T>) {
+                if(prev == curr) return;
+            }
+
+            if(this->open()) Format::changed(res, prev, curr);
+        }
+    }
+};
+
+
+// Spells out `val` on the first hit, and only its changes afterwards. Returns whether there is anything to print.
+template<std::size_t ID, std::size_t I, class Format, class T>
+bool diff(std::string& res, T&& val) {
+    auto&& target = diff_target(std::forward<T>(val));
+
+    auto& prev = snapshot<ID, I, std::remove_cvref_t<decltype(target)>>;
+
+    if(!prev.has_value()) {
+        Format::initial(res, target);
+        prev.emplace(target);
+        return true;
+    }
+
+    differ<Format> walker{ res };
+
+    Format::begin(res);
+    walker(*prev, target);
+    Format::end(res, walker.entries);
+
+    *prev = target;
+
+    return walker.entries > 0;
 }
 
+// Diffs each argument of a `debug_diff(...)` hit against its snapshot; the unchanged ones are left empty.
+template<std::size_t ID, class Format, class... Args>
+std::array<std::optional<std::string>, sizeof...(Args)> diffs(Args&&... vals) {
+    std::array<std::optional<std::string>, sizeof...(Args)> res;
+
+    const std::lock_guard lock(snapshot_mutex<ID>);
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((diff<ID, I, Format>(res[I].emplace(), vals) ? void() : res[I].reset()), ...);
+    }(std::index_sequence_for<Args...>{});
+
+    return res;
+}
+
+
+#if !defined(DEBUGGER_BINARY_TRACE) && !defined(DEBUGGER_JSON_OUTPUT)
+
+// Prints only the arguments, and the elements of them, that changed since the previous hit of the same `debug_diff(...)`.
+template<std::size_t ID, class... Args>
+void debug_diff(
+    const call_site&,
+    const std::span<const std::string_view> args,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    const auto contents = diffs<ID, diff_text>(vals...);
+
+    if(std::ranges::none_of(contents, [](const auto& content) { return content.has_value(); })) return;
+
+    put_header(path, line, current_hit, thread_index());
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+            (
+                contents[I].has_value() ? (
+                    put_name(I < args.size() ? args[I] : ""),
+                    put_type(get_type_name(vals), put_value(debug_t(*contents[I])))
+                ) : void()
+            ),
+            ...
+        );
+    }(std::index_sequence_for<Args...>{});
+
+    put_footer();
+}
+
+#endif
+
 
 } // namespace debugger
+
+
+#ifdef DEBUGGER_BINARY_TRACE
+#include "debugger/trace.hpp"
+#endif
+
+#ifdef DEBUGGER_JSON_OUTPUT
+#include "debugger/json.hpp"
+#endif
@@ -0,0 +1,347 @@
+#pragma once
+
+
+#include <cmath>
+#include <charconv>
+#include <array>
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <span>
+#include <ranges>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+
+
+#include "debugger/debug.hpp"
+
+
+namespace debugger {
+
+namespace json {
+
+
+void put_string(std::string& res, const std::string_view str) {
+    constexpr std::string_view HEX = "0123456789abcdef";
+
+    res += '"';
+    for(const char c : str) {
+        switch(c) {
+            case '"': res += "\\\""; break;
+            case '\\': res += "\\\\"; break;
+            case '\n': res += "\\n"; break;
+            case '\r': res += "\\r"; break;
+            case '\t': res += "\\t"; break;
+            default: {
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    res += "\\u00";
+                    res += HEX[(c >> 4) & 0xF];
+                    res += HEX[c & 0xF];
+                }
+                else {
+                    res += c;
+                }
+            }
+        }
+    }
+    res += '"';
+}
+
+template<uni::internal::arithmetic T>
+void put_number(std::string& res, const T val) {
+    if constexpr(std::is_floating_point_v<T>) {
+        if(std::isnan(val)) return put_string(res, "NaN");
+        if(std::isinf(val)) return put_string(res, val < 0 ? "-Infinity" : "Infinity");
+    }
+
+    std::array<char, NUMBER_BUFFER_SIZE> buffer;
+
+    // Shortest round-trip form for floating-point values.
+    char* end;
+    if constexpr(int128<T>) end = int128_to_chars(buffer.data(), buffer.data() + buffer.size(), val);
+    else end = std::to_chars(buffer.data(), buffer.data() + buffer.size(), val).ptr;
+
+    res.append(buffer.data(), end);
+}
+
+
+template<class T>
+concept map_like =
+    uni::internal::derived_from_template<T, std::map> ||
+    uni::internal::derived_from_template<T, std::unordered_map>;
+
+
+template<class T>
+void put(std::string& res, T&& val);
+
+template<class R>
+void put_array(std::string& res, R&& range) {
+    res += '[';
+
+    bool first = true;
+    for(auto&& v : range) {
+        if(!first) res += ',';
+        put(res, v);
+        first = false;
+    }
+
+    res += ']';
+}
+
+// Keys that are not strings are stored as their JSON text.
+template<class R>
+void put_object(std::string& res, R&& range) {
+    res += '{';
+
+    std::string key;
+
+    bool first = true;
+    for(auto&& [k, v] : range) {
+        if(!first) res += ',';
+
+        if constexpr(std::convertible_to<decltype(k), std::string_view>) {
+            put_string(res, k);
+        }
+        else {
+            key.clear();
+            put(key, k);
+            put_string(res, key);
+        }
+
+        res += ':';
+        put(res, v);
+        first = false;
+    }
+
+    res += '}';
+}
+
+
+// Mirrors the dispatch of `dump()`; whatever has no natural JSON form is stored as its dumped text.
+template<class T>
+void put(std::string& res, T&& val) {
+    using type = std::remove_cvref_t<T>;
+
+    if constexpr(std::same_as<type, debug_t>) {
+        put_string(res, val);
+    }
+    else if constexpr(std::same_as<type, std::nullptr_t>) {
+        res += "null";
+    }
+    else if constexpr(std::same_as<type, bool>) {
+        res += (val ? "true" : "false");
+    }
+    else if constexpr(std::same_as<type, char>) {
+        put_string(res, std::string_view(&val, 1));
+    }
+    else if constexpr(uni::internal::arithmetic<type>) {
+        put_number(res, val);
+    }
+    else if constexpr(std::convertible_to<T, std::string_view>) {
+        put_string(res, val);
+    }
+    else if constexpr(uni::internal::pointer<type>) {
+        put(res, *val);
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::optional>) {
+        if(val.has_value()) put(res, *val);
+        else res += "null";
+    }
+    else if constexpr(std::invocable<dump_loggable, std::string&, T>) {
+        put(res, _debug(val));
+    }
+    else if constexpr(std::invocable<dump_has_val, std::string&, T>) {
+        put(res, val.val());
+    }
+    else if constexpr(std::invocable<dump_bitset, std::string&, T>) {
+        put_string(res, val.to_string());
+    }
+    else if constexpr(std::invocable<dump_iterator, std::string&, T>) {
+        put(res, *val);
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::pair> || uni::internal::derived_from_template<type, std::tuple>) {
+        res += '[';
+        std::apply(
+            [&](auto&&... vs) {
+                bool first = true;
+                ((res += (first ? "" : ","), put(res, vs), first = false), ...);
+            },
+            val
+        );
+        res += ']';
+    }
+    else if constexpr(map_like<type>) {
+        put_object(res, val);
+    }
+    else if constexpr(
+        uni::internal::derived_from_template<type, std::queue> ||
+        uni::internal::derived_from_template<type, std::stack> ||
+        uni::internal::derived_from_template<type, std::priority_queue>
+    ) {
+        put_array(res, adaptor_access<type>::container(val));
+    }
+    else if constexpr(std::ranges::input_range<T>) {
+        put_array(res, val);
+    }
+    else {
+        put_string(res, dump(val));
+    }
+}
+
+
+template<class T>
+const std::string& type_name() {
+    static const std::string name = demangle(typeid(T).name());
+    return name;
+}
+
+
+// Opens a record up to its list of arguments: `{"file":...,"line":...,"hit":...,"thread":...,"args":[`
+void open_record(std::string& res, const int line, const std::string_view path) {
+    res += "{\"file\":";
+    put_string(res, path.substr(path.find_last_of('/') + 1));
+    res += ",\"line\":";
+    put_number(res, line);
+    res += ",\"hit\":";
+    put_number(res, current_hit);
+    res += ",\"thread\":";
+    put_number(res, thread_index());
+    res += ",\"args\":[";
+}
+
+// Opens the object of an argument, up to the field that holds what is reported about it.
+template<class T>
+void open_argument(std::string& res, const bool first, const std::string_view name) {
+    res += (first ? "{\"name\":" : ",{\"name\":");
+    put_string(res, name);
+    res += ",\"type\":";
+    put_string(res, type_name<std::remove_cvref_t<T>>());
+}
+
+
+// Spells out what `differ` finds as the fields of an argument: `"value":...` on the first hit, and
+//   "changes":[{"path":[1,2],"old":0,"new":3},{"path":[4],"new":5}],"elided":7
+// afterwards, where a missing "old" or "new" means that the element was added or removed.
+struct diff_format {
+    template<class T>
+    static void initial(std::string& res, const T& val) {
+        res += "\"value\":";
+        put(res, val);
+    }
+
+    static void begin(std::string& res) { res += "\"changes\":["; }
+
+    // The number of changes beyond the elision limit.
+    static void end(std::string& res, const std::size_t entries) {
+        res += ']';
+        if(entries > elision.max_elements) {
+            res += ",\"elided\":";
+            put_number(res, entries - elision.max_elements);
+        }
+    }
+
+    static void elide(std::string&, const std::size_t) {}
+
+    static void entry(std::string& res, const std::span<const std::size_t> path, const std::size_t index) {
+        res += (index == 0 ? "{\"path\":" : ",{\"path\":");
+        put_array(res, path);
+    }
+
+    template<class T>
+    static void removed(std::string& res, const T& prev) {
+        res += ",\"old\":";
+        put(res, prev);
+        res += '}';
+    }
+
+    template<class T>
+    static void added(std::string& res, const T& curr) {
+        res += ",\"new\":";
+        put(res, curr);
+        res += '}';
+    }
+
+    template<class T>
+    static void changed(std::string& res, const T& prev, const T& curr) {
+        res += ",\"old\":";
+        put(res, prev);
+        res += ",\"new\":";
+        put(res, curr);
+        res += '}';
+    }
+};
+
+
+} // namespace json
+
+
+#ifdef DEBUGGER_JSON_OUTPUT
+
+// Emits one JSON object per record:
+//   {"file":"main.cpp","line":12,"hit":0,"thread":0,"args":[{"name":"v","type":"std::vector<int>","value":[1,2]}]}
+template<class... Args>
+void debug(
+    const call_site&,
+    const std::span<const std::string_view> args, const size_t,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    json::open_record(buffer, line, path);
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+            (
+                json::open_argument<Args>(buffer, I == 0, I < args.size() ? args[I] : ""),
+                buffer += ",\"value\":",
+                json::put(buffer, vals),
+                buffer += '}'
+            ),
+            ...
+        );
+    }(std::index_sequence_for<Args...>{});
+
+    buffer += "]}\n";
+    flush_buffer();
+}
+
+
+// Emits one JSON object per hit with any change, holding only the changed arguments:
+//   {"file":"main.cpp","line":12,"hit":1,"thread":0,"args":[{"name":"v","type":"std::vector<int>","changes":[{"path":[0],"old":0,"new":1}]}]}
+template<std::size_t ID, class... Args>
+void debug_diff(
+    const call_site&,
+    const std::span<const std::string_view> args,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    const auto contents = diffs<ID, json::diff_format>(vals...);
+
+    if(std::ranges::none_of(contents, [](const auto& content) { return content.has_value(); })) return;
+
+    json::open_record(buffer, line, path);
+
+    bool first = true;
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+            [&] {
+                if(!contents[I].has_value()) return;
+
+                json::open_argument<Args>(buffer, std::exchange(first, false), I < args.size() ? args[I] : "");
+                buffer += ',';
+                buffer += *contents[I];
+                buffer += '}';
+            }(),
+            ...
+        );
+    }(std::index_sequence_for<Args...>{});
+
+    buffer += "]}\n";
+    flush_buffer();
+}
+
+#endif
+
+
+} // namespace debugger
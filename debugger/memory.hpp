@@ -0,0 +1,250 @@
+#pragma once
+
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iomanip>
+#include <span>
+#include <array>
+#include <vector>
+#include <valarray>
+#include <deque>
+#include <list>
+#include <forward_list>
+#include <set>
+#include <map>
+#include <unordered_set>
+#include <unordered_map>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <mutex>
+#include <ranges>
+#include <concepts>
+#include <type_traits>
+
+
+#include "internal/type_traits.hpp"
+
+#include "debugger/debug.hpp"
+
+
+namespace debugger {
+
+
+template<class T>
+auto _memory(T&& val) -> decltype(val._memory()) {
+    return val._memory();
+}
+
+
+template<class T>
+concept memory_reportable = requires (T&& val) { { _memory(val) } -> std::convertible_to<std::size_t>; };
+
+
+template<class T>
+std::size_t memory(const T& val);
+
+namespace internal {
+
+
+// What the standard node-based containers keep beside each element (libstdc++ layout).
+constexpr std::size_t LIST_NODE_OVERHEAD = 2 * sizeof(void*);
+constexpr std::size_t FORWARD_LIST_NODE_OVERHEAD = sizeof(void*);
+constexpr std::size_t TREE_NODE_OVERHEAD = 4 * sizeof(void*);
+constexpr std::size_t HASH_NODE_OVERHEAD = 2 * sizeof(void*);
+
+
+template<class R>
+std::size_t elements(const R& range) {
+    std::size_t res = 0;
+    for(const auto& v : range) res += memory(v);
+    return res;
+}
+
+template<class T>
+concept node_based =
+    uni::internal::derived_from_template<T, std::list> ||
+    uni::internal::derived_from_template<T, std::set> ||
+    uni::internal::derived_from_template<T, std::multiset> ||
+    uni::internal::derived_from_template<T, std::map> ||
+    uni::internal::derived_from_template<T, std::multimap>;
+
+template<class T>
+concept hashed =
+    uni::internal::derived_from_template<T, std::unordered_set> ||
+    uni::internal::derived_from_template<T, std::unordered_multiset> ||
+    uni::internal::derived_from_template<T, std::unordered_map> ||
+    uni::internal::derived_from_template<T, std::unordered_multimap>;
+
+
+// `std::array` and the like, which hold their elements in place.
+template<class T>
+concept fixed_array = std::ranges::range<const T> && requires { std::tuple_size<T>::value; };
+
+
+} // namespace internal
+
+
+// Heap bytes held by `val`, not counting `sizeof(val)` itself.
+// Types may report their own footprint through a `_memory()` hook, just as they customize `dump()` through `_debug()`.
+template<class T>
+std::size_t memory(const T& val) {
+    using type = std::remove_cvref_t<T>;
+
+    if constexpr(memory_reportable<const T&>) {
+        return static_cast<std::size_t>(_memory(val));
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::basic_string>) {
+        const auto data = reinterpret_cast<const std::byte*>(val.data());
+        const auto self = reinterpret_cast<const std::byte*>(&val);
+
+        // Short strings live inside the object.
+        if(self <= data && data < self + sizeof(val)) return 0;
+        return (val.capacity() + 1) * sizeof(typename type::value_type);
+    }
+    else if constexpr(std::same_as<type, std::vector<bool>>) {
+        return (val.capacity() + 7) / 8;
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::vector>) {
+        return val.capacity() * sizeof(typename type::value_type) + internal::elements(val);
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::valarray> || uni::internal::derived_from_template<type, std::deque>) {
+        return std::size(val) * sizeof(typename type::value_type) + internal::elements(val);
+    }
+    else if constexpr(internal::node_based<type>) {
+        return val.size() * (sizeof(typename type::value_type) + (
+            uni::internal::derived_from_template<type, std::list> ? internal::LIST_NODE_OVERHEAD : internal::TREE_NODE_OVERHEAD
+        )) + internal::elements(val);
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::forward_list>) {
+        return static_cast<std::size_t>(std::ranges::distance(val)) * (sizeof(typename type::value_type) + internal::FORWARD_LIST_NODE_OVERHEAD) + internal::elements(val);
+    }
+    else if constexpr(internal::hashed<type>) {
+        return
+            val.size() * (sizeof(typename type::value_type) + internal::HASH_NODE_OVERHEAD) +
+            val.bucket_count() * sizeof(void*) +
+            internal::elements(val);
+    }
+    else if constexpr(
+        uni::internal::derived_from_template<type, std::queue> ||
+        uni::internal::derived_from_template<type, std::stack> ||
+        uni::internal::derived_from_template<type, std::priority_queue>
+    ) {
+        return memory(adaptor_access<type>::container(val));
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::optional>) {
+        return val.has_value() ? memory(*val) : 0;
+    }
+    else if constexpr(uni::internal::derived_from_template<type, std::pair> || uni::internal::derived_from_template<type, std::tuple>) {
+        return std::apply([](const auto&... vs) { return (std::size_t{ 0 } + ... + memory(vs)); }, val);
+    }
+    else if constexpr(std::is_array_v<type> || internal::fixed_array<type>) {
+        return internal::elements(val);
+    }
+    else {
+        return 0;
+    }
+}
+
+
+// "1.50 MiB (1572864 bytes)"
+std::string format_bytes(const std::size_t bytes) {
+    constexpr std::array<std::string_view, 4> UNITS = { "B", "KiB", "MiB", "GiB" };
+
+    long double size = static_cast<long double>(bytes);
+    std::size_t unit = 0;
+    while(size >= 1024 && unit + 1 < UNITS.size()) size /= 1024, ++unit;
+
+    std::stringstream res;
+    if(unit == 0) res << bytes << " " << UNITS[0];
+    else res << std::fixed << std::setprecision(2) << size << " " << UNITS[unit] << " (" << bytes << " bytes)";
+
+    return res.str();
+}
+
+
+#ifdef DEBUGGER_JSON_OUTPUT
+
+// Emits one JSON object per call, with the footprints in bytes:
+//   {"file":"main.cpp","line":12,"hit":0,"thread":0,"args":[{"name":"v","type":"std::vector<int>","bytes":12}]}
+template<class... Args>
+void debug_memory(
+    const call_site&,
+    const std::span<const std::string_view> args,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    json::open_record(buffer, line, path);
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+            (
+                json::open_argument<Args>(buffer, I == 0, I < args.size() ? args[I] : ""),
+                buffer += ",\"bytes\":",
+                json::put_number(buffer, memory(vals)),
+                buffer += '}'
+            ),
+            ...
+        );
+    }(std::index_sequence_for<Args...>{});
+
+    buffer += "]}\n";
+    flush_buffer();
+}
+
+#elif defined(DEBUGGER_BINARY_TRACE)
+
+// Records the footprints into the trace, as the text `debug_memory(...)` prints.
+template<class... Args>
+void debug_memory(
+    call_site& site,
+    const std::span<const std::string_view> args,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    const std::lock_guard lock(trace_mutex);
+
+    auto& out = trace_output;
+
+    const std::array<std::uint32_t, sizeof...(Args)> types = { trace::type_id<std::remove_cvref_t<Args>>(out)... };
+
+    open_hit(site, args, line, path, sizeof...(Args));
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((out.put(types[I]), trace::record(out, debug_t(format_bytes(memory(vals))))), ...);
+    }(std::index_sequence_for<Args...>{});
+}
+
+#else
+
+// Prints the heap footprint of each argument in the layout of `debug(...)`.
+template<class... Args>
+void debug_memory(
+    const call_site&,
+    const std::span<const std::string_view> args,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    put_header(path, line, current_hit, thread_index());
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        (
+            (
+                put_name(I < args.size() ? args[I] : ""),
+                put_type(get_type_name(vals), put_value(debug_t(format_bytes(memory(vals)))))
+            ),
+            ...
+        );
+    }(std::index_sequence_for<Args...>{});
+
+    put_footer();
+}
+
+#endif
+
+
+} // namespace debugger
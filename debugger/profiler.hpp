@@ -0,0 +1,185 @@
+#pragma once
+
+
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <chrono>
+#include <atomic>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+
+#include "debugger/debug.hpp"
+
+
+namespace debugger {
+
+namespace profiler {
+
+
+// Raw ticks of the cheapest monotonic counter available; converted to time only when reporting.
+inline std::uint64_t ticks() noexcept {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+
+// Statistics of a single `profile(...)` expansion.
+struct entry {
+    std::string_view name, path;
+    int line;
+
+    std::atomic<std::uint64_t> calls = 0, total = 0;
+    std::atomic<std::uint64_t> min = std::numeric_limits<std::uint64_t>::max(), max = 0;
+
+    entry(const std::string_view label, const std::string_view file, const int at) noexcept
+      : name(label), path(file.substr(file.find_last_of('/') + 1)), line(at)
+    {}
+
+    void add(const std::uint64_t elapsed) noexcept {
+        this->calls.fetch_add(1, std::memory_order_relaxed);
+        this->total.fetch_add(elapsed, std::memory_order_relaxed);
+
+        auto least = this->min.load(std::memory_order_relaxed);
+        while(elapsed < least and !this->min.compare_exchange_weak(least, elapsed, std::memory_order_relaxed));
+
+        auto most = this->max.load(std::memory_order_relaxed);
+        while(elapsed > most and !this->max.compare_exchange_weak(most, elapsed, std::memory_order_relaxed));
+    }
+};
+
+
+// Collects the entries, and prints them sorted by total time when the program exits; as NDJSON under `DEBUGGER_JSON_OUTPUT`.
+struct registry {
+  private:
+    std::deque<entry> _entries;
+    std::mutex _mutex;
+
+    // Taken at both ends of the run, to convert ticks into nanoseconds.
+    std::uint64_t _ticks = ticks();
+    std::chrono::steady_clock::time_point _time = std::chrono::steady_clock::now();
+
+  public:
+    entry& enroll(const std::string_view name, const std::string_view path, const int line) {
+        const std::lock_guard lock(this->_mutex);
+        return this->_entries.emplace_back(name, path, line);
+    }
+
+    std::string report() {
+        const std::lock_guard lock(this->_mutex);
+
+        const auto elapsed_ticks = ticks() - this->_ticks;
+        const auto elapsed_time = std::chrono::duration<long double, std::milli>(std::chrono::steady_clock::now() - this->_time).count();
+        const long double ms_per_tick = elapsed_ticks > 0 ? elapsed_time / static_cast<long double>(elapsed_ticks) : 0;
+
+        std::vector<const entry*> entries;
+        for(const auto& record : this->_entries) {
+            if(record.calls.load(std::memory_order_relaxed) > 0) entries.push_back(&record);
+        }
+
+        std::ranges::sort(entries, std::ranges::greater{}, [](const entry* record) { return record->total.load(std::memory_order_relaxed); });
+
+#ifdef DEBUGGER_JSON_OUTPUT
+
+        // One object per entry, in the same stream as the records:
+        //   {"profile":"solve","file":"main.cpp","line":12,"calls":3,"total_ms":1.5,"mean_ms":0.5,"min_ms":0.4,"max_ms":0.6}
+        std::string res;
+
+        for(const auto* record : entries) {
+            const auto calls = record->calls.load(std::memory_order_relaxed);
+            const auto total = static_cast<long double>(record->total.load(std::memory_order_relaxed)) * ms_per_tick;
+
+            res += "{\"profile\":";
+            json::put_string(res, record->name);
+            res += ",\"file\":";
+            json::put_string(res, record->path);
+            res += ",\"line\":";
+            json::put_number(res, record->line);
+            res += ",\"calls\":";
+            json::put_number(res, calls);
+            res += ",\"total_ms\":";
+            json::put_number(res, total);
+            res += ",\"mean_ms\":";
+            json::put_number(res, total / static_cast<long double>(calls));
+            res += ",\"min_ms\":";
+            json::put_number(res, static_cast<long double>(record->min.load(std::memory_order_relaxed)) * ms_per_tick);
+            res += ",\"max_ms\":";
+            json::put_number(res, static_cast<long double>(record->max.load(std::memory_order_relaxed)) * ms_per_tick);
+            res += "}\n";
+        }
+
+        return res;
+
+#else
+
+        std::stringstream res;
+        res << std::fixed << std::setprecision(3);
+
+        res << COLOR_INIT << "\n" << COLOR_LINE << "profile" << COLOR_INIT << " (" << elapsed_time << " ms in total)\n";
+        res << std::left << std::setw(24) << "name" << std::setw(24) << "location" << std::right
+            << std::setw(12) << "calls" << std::setw(14) << "total [ms]" << std::setw(14) << "mean [ms]"
+            << std::setw(14) << "min [ms]" << std::setw(14) << "max [ms]" << "\n";
+
+        for(const auto* record : entries) {
+            const auto calls = record->calls.load(std::memory_order_relaxed);
+            const auto total = static_cast<long double>(record->total.load(std::memory_order_relaxed)) * ms_per_tick;
+
+            const std::string location = std::string(record->path) + " #" + std::to_string(record->line);
+
+            res << COLOR_IDENTIFIER << std::left << std::setw(24) << record->name << COLOR_INIT
+                << std::setw(24) << location << std::right
+                << std::setw(12) << calls
+                << std::setw(14) << total
+                << std::setw(14) << total / static_cast<long double>(calls)
+                << std::setw(14) << static_cast<long double>(record->min.load(std::memory_order_relaxed)) * ms_per_tick
+                << std::setw(14) << static_cast<long double>(record->max.load(std::memory_order_relaxed)) * ms_per_tick
+                << "\n";
+        }
+
+        return res.str();
+
+#endif
+    }
+
+    // Declared after the output sink, so this runs before the sink is torn down.
+    ~registry() {
+        if(this->_entries.empty()) return;
+        emit(this->report());
+    }
+};
+
+registry entries;
+
+
+// Adds the lifetime of this object to `target`.
+struct scope {
+  private:
+    entry& _target;
+    std::uint64_t _start;
+
+  public:
+    explicit scope(entry& target) noexcept : _target(target), _start(ticks()) {}
+
+    scope(const scope&) = delete;
+    scope& operator=(const scope&) = delete;
+
+    ~scope() { this->_target.add(ticks() - this->_start); }
+};
+
+
+} // namespace profiler
+
+} // namespace debugger
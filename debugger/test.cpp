@@ -152,5 +152,23 @@ signed main() {
     prique.push(3), prique.push(1), prique.push(4), prique.push(1);
     debug(prique);
 
+    for(int i = 0; i < 10; ++i) {
+        debug_every(4, i);
+        debug_first(2, i);
+        debug_rate(3, i);
+    }
+
+    vector<vector<int>> dp(3, vector<int>(4));
+    for(int i = 0; i < 3; ++i) {
+        profile("fill dp");
+        dp[i][i] = i + 1;
+        debug_diff(dp);
+    }
+    debug_memory(dp);
+
+    vector<thread> workers;
+    for(int t = 0; t < 2; ++t) workers.emplace_back([t] { debug(t); });
+    for(auto& worker : workers) worker.join();
+
     return 0;
 }
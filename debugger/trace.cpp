@@ -0,0 +1,166 @@
+/*
+ * Renders a trace recorded with DEBUGGER_BINARY_TRACE, in the same format as `debug(...)`.
+ *
+ *   g++ -std=gnu++20 -O2 -I. [-DDEBUGGER_COLORED_OUTPUT] debugger/trace.cpp -o trace
+ *   ./trace debug.trace
+ */
+
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+
+#include "debugger/trace.hpp"
+
+
+namespace {
+
+
+using namespace debugger;
+
+
+template<std::size_t I = 0>
+void decode_arithmetic(std::string& res, trace::reader& in, const std::size_t index) {
+    if constexpr(I < std::tuple_size_v<trace::arithmetics>) {
+        if(index == I) return dump(res, in.get<std::tuple_element_t<I, trace::arithmetics>>());
+        decode_arithmetic<I + 1>(res, in, index);
+    }
+}
+
+
+Brackets brackets_of(const char bracket) {
+    if(bracket == '{') return { "{", "}" };
+    if(bracket == '<') return { "<", ">" };
+    return { "[", "]" };
+}
+
+
+void decode(std::string& res, trace::reader& in) {
+    const auto tag = in.get<trace::tag>();
+
+    switch(tag) {
+        case trace::tag::array: {
+            const auto bracket = in.get<char>();
+            const auto index = in.get<std::uint8_t>();
+
+            std::vector<debug_t> elements(in.get<std::uint64_t>());
+            {
+                const nesting guard;
+                for(auto& element : elements) decode_arithmetic(element, in, index);
+            }
+
+            return dump_range_impl(res, elements, brackets_of(bracket));
+        }
+        case trace::tag::range: {
+            const auto bracket = in.get<char>();
+
+            std::vector<debug_t> elements(in.get<std::uint64_t>());
+            {
+                const nesting guard;
+                for(auto& element : elements) decode(element, in);
+            }
+
+            return dump_range_impl(res, elements, brackets_of(bracket));
+        }
+        case trace::tag::tuple: {
+            const auto size = in.get<std::uint64_t>();
+
+            res += "( ";
+            for(std::uint64_t i = 0; i < size; ++i) {
+                if(i > 0) res += ", ";
+                decode(res, in);
+            }
+            res += " )";
+
+            return;
+        }
+        case trace::tag::string: {
+            return dump(res, std::string(in.get_string()));
+        }
+        case trace::tag::c_string: {
+            return dump(res, std::string(in.get_string()).c_str());
+        }
+        case trace::tag::text: {
+            res += in.get_string();
+            return;
+        }
+        default: {
+            return decode_arithmetic(res, in, static_cast<std::size_t>(tag) - static_cast<std::size_t>(trace::tag::arithmetic));
+        }
+    }
+}
+
+
+struct site_info {
+    int line;
+    std::string_view file;
+    std::vector<std::string_view> names;
+};
+
+
+} // namespace
+
+
+signed main(int argc, char* argv[]) {
+    if(argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <trace file>" << std::endl;
+        return 1;
+    }
+
+    debugger::cdebug = &std::cout;
+
+    trace::reader in(argv[1]);
+
+    if(in.get_bytes(trace::MAGIC.size()) != trace::MAGIC) {
+        std::cerr << argv[1] << ": not a trace file" << std::endl;
+        return 1;
+    }
+
+    std::unordered_map<std::uint32_t, site_info> sites;
+    std::unordered_map<std::uint32_t, std::string> types;
+
+    while(!in.empty()) {
+        const auto kind = in.get<trace::entry>();
+
+        if(kind == trace::entry::end) break;
+
+        if(kind == trace::entry::site) {
+            auto& site = sites[in.get<std::uint32_t>()];
+            site.line = in.get<std::int32_t>();
+            site.file = in.get_string();
+            site.names.resize(in.get<std::uint32_t>());
+            for(auto& name : site.names) name = in.get_string();
+        }
+
+        if(kind == trace::entry::type) {
+            const auto id = in.get<std::uint32_t>();
+            types[id] = COLOR_TYPE + std::string(in.get_string()) + COLOR_INIT;
+        }
+
+        if(kind == trace::entry::hit) {
+            const auto& site = sites[in.get<std::uint32_t>()];
+            const auto hit = in.get<std::uint64_t>();
+            put_header(site.file, site.line, hit, in.get<std::uint32_t>());
+
+            const auto count = in.get<std::uint32_t>();
+
+            for(std::uint32_t i = 0; i < count; ++i) {
+                const auto type = in.get<std::uint32_t>();
+                if(type == 0) continue;
+
+                const auto& type_name = types[type];
+
+                std::string content;
+                decode(content, in);
+
+                put_name(i < site.names.size() ? site.names[i] : "");
+                put_type(type_name, put_value(debug_t(content)));
+            }
+
+            put_footer();
+        }
+    }
+
+    return 0;
+}
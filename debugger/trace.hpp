@@ -0,0 +1,423 @@
+#pragma once
+
+
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <span>
+#include <ranges>
+#include <concepts>
+#include <type_traits>
+#include <utility>
+#include <mutex>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+
+#include "debugger/debug.hpp"
+
+
+namespace debugger {
+
+namespace trace {
+
+
+// Layout of a trace file:
+//   MAGIC, then records until EOF or a zero byte (a trace cut short by a crash is zero-padded).
+//   site : `entry::site`, id (u32), line (i32), file (str), count (u32), names (str)...
+//   type : `entry::type`, id (u32), demangled name (str)
+//   hit  : `entry::hit`, site id (u32), hit (u64), thread (u32), count (u32), (type id (u32), value)...
+// where str = length (u64), bytes.
+// A type id of 0 has no value: the argument is left out, as `debug_diff(...)` does with the unchanged ones.
+//
+// A value starts with its tag:
+//   arithmetic + i : raw bytes of std::tuple_element_t<i, arithmetics>
+//   array  : brackets (char), element tag, length (u64), raw bytes
+//   range  : brackets (char), length (u64), values...
+//   tuple  : length (u64), values...
+//   string, c_string, text : str
+constexpr std::string_view MAGIC = "DBGTRC03";
+
+enum class entry : std::uint8_t {
+    end = 0, site = 'S', type = 'T', hit = 'H'
+};
+
+enum class tag : std::uint8_t {
+    arithmetic = 0x00,
+    array = 0x40, range, tuple, string, c_string, text
+};
+
+
+using arithmetics = std::tuple<
+    bool, char, signed char, unsigned char,
+    short, unsigned short, int, unsigned int, long, unsigned long, long long, unsigned long long,
+    __int128_t, __uint128_t,
+    float, double, long double
+>;
+
+template<class T, std::size_t I = 0>
+consteval std::size_t arithmetic_index() {
+    if constexpr(I == std::tuple_size_v<arithmetics>) return I;
+    else if constexpr(std::same_as<T, std::tuple_element_t<I, arithmetics>>) return I;
+    else return arithmetic_index<T, I + 1>();
+}
+
+template<class T>
+concept traceable_arithmetic = arithmetic_index<T>() < std::tuple_size_v<arithmetics>;
+
+
+// Appends to a memory-mapped file, growing it geometrically.
+struct writer {
+  private:
+    int _fd = -1;
+    char* _data = nullptr;
+    std::size_t _capacity = 0, _size = 0;
+
+    void _reserve(const std::size_t size) {
+        if(this->_size + size <= this->_capacity) return;
+
+        const auto capacity = std::max({ this->_capacity * 2, this->_size + size, static_cast<std::size_t>(1) << 20 });
+
+        if(this->_data != nullptr) ::munmap(this->_data, this->_capacity);
+
+        [[maybe_unused]] const int truncated = ::ftruncate(this->_fd, static_cast<off_t>(capacity));
+        assert(truncated == 0);
+
+        void* const data = ::mmap(nullptr, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, this->_fd, 0);
+        assert(data != MAP_FAILED);
+
+        this->_data = static_cast<char*>(data);
+        this->_capacity = capacity;
+    }
+
+  public:
+    explicit writer(const char* const path) {
+        this->_fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+        assert(this->_fd >= 0);
+
+        this->write(MAGIC.data(), MAGIC.size());
+    }
+
+    writer(const writer&) = delete;
+    writer& operator=(const writer&) = delete;
+
+    ~writer() {
+        if(this->_data != nullptr) ::munmap(this->_data, this->_capacity);
+        [[maybe_unused]] const int truncated = ::ftruncate(this->_fd, static_cast<off_t>(this->_size));
+        ::close(this->_fd);
+    }
+
+    inline std::size_t size() const noexcept { return this->_size; }
+
+    void write(const void* const src, const std::size_t size) {
+        this->_reserve(size);
+        std::memcpy(this->_data + this->_size, src, size);
+        this->_size += size;
+    }
+
+    template<class T>
+        requires std::is_trivially_copyable_v<T>
+    void put(const T& val) { this->write(&val, sizeof(T)); }
+
+    void put_string(const std::string_view str) {
+        this->put<std::uint64_t>(str.size());
+        this->write(str.data(), str.size());
+    }
+
+    // Overwrites a value written at `offset`, e.g. the length of a range that was not known in advance.
+    template<class T>
+        requires std::is_trivially_copyable_v<T>
+    void patch(const std::size_t offset, const T& val) {
+        std::memcpy(this->_data + offset, &val, sizeof(T));
+    }
+};
+
+
+// Reads a whole trace file through a read-only mapping.
+struct reader {
+  private:
+    const char* _data = nullptr;
+    std::size_t _size = 0, _pos = 0;
+
+  public:
+    explicit reader(const char* const path) {
+        const int fd = ::open(path, O_RDONLY);
+        assert(fd >= 0);
+
+        struct stat info;
+        ::fstat(fd, &info);
+        this->_size = static_cast<std::size_t>(info.st_size);
+
+        if(this->_size > 0) {
+            void* const data = ::mmap(nullptr, this->_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            assert(data != MAP_FAILED);
+            this->_data = static_cast<const char*>(data);
+        }
+
+        ::close(fd);
+    }
+
+    reader(const reader&) = delete;
+    reader& operator=(const reader&) = delete;
+
+    ~reader() {
+        if(this->_data != nullptr) ::munmap(const_cast<char*>(this->_data), this->_size);
+    }
+
+    inline bool empty() const noexcept { return this->_pos >= this->_size; }
+
+    std::string_view get_bytes(const std::size_t size) {
+        assert(this->_pos + size <= this->_size);
+        const std::string_view res(this->_data + this->_pos, size);
+        this->_pos += size;
+        return res;
+    }
+
+    template<class T>
+        requires std::is_trivially_copyable_v<T>
+    T get() {
+        T res;
+        std::memcpy(&res, this->get_bytes(sizeof(T)).data(), sizeof(T));
+        return res;
+    }
+
+    std::string_view get_string() { return this->get_bytes(this->get<std::uint64_t>()); }
+};
+
+
+template<class T>
+concept set_like =
+    uni::internal::derived_from_template<T, std::map> ||
+    uni::internal::derived_from_template<T, std::multimap> ||
+    uni::internal::derived_from_template<T, std::unordered_map> ||
+    uni::internal::derived_from_template<T, std::unordered_multimap> ||
+    uni::internal::derived_from_template<T, std::set> ||
+    uni::internal::derived_from_template<T, std::multiset> ||
+    uni::internal::derived_from_template<T, std::unordered_set> ||
+    uni::internal::derived_from_template<T, std::unordered_multiset>;
+
+template<class T>
+concept container_adaptor =
+    uni::internal::derived_from_template<T, std::queue> ||
+    uni::internal::derived_from_template<T, std::stack> ||
+    uni::internal::derived_from_template<T, std::priority_queue>;
+
+
+template<class T>
+void record(writer& out, T&& val);
+
+template<class R>
+void record_range(writer& out, R&& range, const char bracket) {
+    using value_type = std::remove_cvref_t<std::ranges::range_reference_t<R>>;
+
+    if constexpr(
+        std::ranges::contiguous_range<R> && std::ranges::sized_range<R> &&
+        traceable_arithmetic<value_type> && std::same_as<std::ranges::range_value_t<R>, value_type>
+    ) {
+        const auto size = static_cast<std::uint64_t>(std::ranges::size(range));
+
+        out.put(tag::array);
+        out.put(bracket);
+        out.put(static_cast<std::uint8_t>(arithmetic_index<value_type>()));
+        out.put(size);
+        out.write(std::ranges::data(range), size * sizeof(value_type));
+    }
+    else {
+        out.put(tag::range);
+        out.put(bracket);
+
+        const auto offset = out.size();
+        out.put<std::uint64_t>(0);
+
+        std::uint64_t size = 0;
+        for(auto&& v : range) record(out, v), ++size;
+
+        out.patch(offset, size);
+    }
+}
+
+// Mirrors the dispatch of `dump()`: whatever is not traced structurally is stored pre-formatted.
+template<class T>
+void record(writer& out, T&& val) {
+    using type = std::remove_cvref_t<T>;
+
+    const auto text = [&]() {
+        out.put(tag::text);
+        out.put_string(dump(val));
+    };
+
+    if constexpr(std::same_as<type, debug_t>) {
+        text();
+    }
+    else if constexpr(std::invocable<dump_primitive_like, std::string&, T>) {
+        if constexpr(traceable_arithmetic<type>) {
+            out.put(static_cast<tag>(static_cast<std::uint8_t>(tag::arithmetic) + arithmetic_index<type>()));
+            out.put(val);
+        }
+        else if constexpr(std::same_as<type, std::string>) {
+            out.put(tag::string);
+            out.put_string(val);
+        }
+        else if constexpr(std::same_as<std::decay_t<T>, const char*>) {
+            out.put(tag::c_string);
+            out.put_string(val);
+        }
+        else {
+            text();
+        }
+    }
+    else if constexpr(std::invocable<dump_loggable, std::string&, T>) {
+        auto&& log = _debug(val);
+
+        if constexpr(std::same_as<std::remove_cvref_t<decltype(log)>, debug_t>) text();
+        else record(out, log);
+    }
+    else if constexpr(std::invocable<dump_has_val, std::string&, T>) {
+        record(out, val.val());
+    }
+    else if constexpr(std::invocable<dump_bitset, std::string&, T> || std::invocable<dump_iterator, std::string&, T>) {
+        text();
+    }
+    else if constexpr(std::invocable<dump_wrapper, std::string&, T>) {
+        if constexpr(uni::internal::derived_from_template<type, std::pair> || uni::internal::derived_from_template<type, std::tuple>) {
+            out.put(tag::tuple);
+            out.put<std::uint64_t>(std::tuple_size_v<type>);
+            std::apply([&](auto&&... vs) { (record(out, vs), ...); }, val);
+        }
+        else if constexpr(container_adaptor<type>) {
+            text();
+        }
+        else {
+            record_range(out, val, set_like<type> ? '{' : '[');
+        }
+    }
+    else if constexpr(std::invocable<dump_range, std::string&, T>) {
+        record_range(out, val, '[');
+    }
+    else {
+        text();
+    }
+}
+
+
+// Type ids are assigned on first use, and their names are written at the same time.
+inline std::uint32_t types = 0;
+
+template<class T>
+std::uint32_t type_id(writer& out) {
+    static const std::uint32_t id = [&]() {
+        const auto assigned = ++types;
+        out.put(entry::type);
+        out.put(assigned);
+        out.put_string(demangle(typeid(T).name()));
+        return assigned;
+    }();
+    return id;
+}
+
+inline std::uint32_t sites = 0;
+
+
+} // namespace trace
+
+
+#ifdef DEBUGGER_BINARY_TRACE
+
+#ifndef DEBUGGER_TRACE_FILE
+#define DEBUGGER_TRACE_FILE "debug.trace"
+#endif
+
+trace::writer trace_output{ DEBUGGER_TRACE_FILE };
+std::mutex trace_mutex;
+
+
+// Writes the site on its first hit, and then the head of a hit of `count` values.
+// Called while holding `trace_mutex`, after the types of the values have been written.
+void open_hit(
+    call_site& site,
+    const std::span<const std::string_view> args,
+    const int line, const std::string_view path,
+    const std::uint32_t count
+) {
+    auto& out = trace_output;
+
+    if(site.trace_id == 0) {
+        site.trace_id = ++trace::sites;
+
+        out.put(trace::entry::site);
+        out.put(site.trace_id);
+        out.put<std::int32_t>(line);
+        out.put_string(path.substr(path.find_last_of('/') + 1));
+        out.put<std::uint32_t>(static_cast<std::uint32_t>(args.size()));
+        for(const auto name : args) out.put_string(name);
+    }
+
+    out.put(trace::entry::hit);
+    out.put(site.trace_id);
+    out.put<std::uint64_t>(current_hit);
+    out.put<std::uint32_t>(static_cast<std::uint32_t>(thread_index()));
+    out.put(count);
+}
+
+
+// Records the values instead of formatting them; render the trace with `debugger/trace.cpp`.
+// A record is written while holding `trace_mutex`, so that records of different threads do not interleave.
+template<class... Args>
+void debug(
+    call_site& site,
+    const std::span<const std::string_view> args, const size_t,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    const std::lock_guard lock(trace_mutex);
+
+    auto& out = trace_output;
+
+    const std::array<std::uint32_t, sizeof...(Args)> types = { trace::type_id<std::remove_cvref_t<Args>>(out)... };
+
+    open_hit(site, args, line, path, sizeof...(Args));
+
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+        ((out.put(types[I]), trace::record(out, vals)), ...);
+    }(std::index_sequence_for<Args...>{});
+}
+
+
+// Records the changes of each argument as the text `debug_diff(...)` prints; the unchanged arguments are left out.
+template<std::size_t ID, class... Args>
+void debug_diff(
+    call_site& site,
+    const std::span<const std::string_view> args,
+    const int line, const std::string_view path,
+    Args&&... vals
+) {
+    const auto contents = diffs<ID, diff_text>(vals...);
+
+    if(std::ranges::none_of(contents, [](const auto& content) { return content.has_value(); })) return;
+
+    const std::lock_guard lock(trace_mutex);
+
+    auto& out = trace_output;
+
+    const std::array<std::uint32_t, sizeof...(Args)> types = { trace::type_id<std::remove_cvref_t<Args>>(out)... };
+
+    open_hit(site, args, line, path, sizeof...(Args));
+
+    for(std::size_t i = 0; i < sizeof...(Args); ++i) {
+        if(contents[i].has_value()) out.put(types[i]), trace::record(out, debug_t(*contents[i]));
+        else out.put<std::uint32_t>(0);
+    }
+}
+
+#endif
+
+
+} // namespace debugger
@@ -0,0 +1,44 @@
+#pragma once
+
+
+#include <cstddef>
+#include <new>
+#include <algorithm>
+
+
+namespace uni {
+
+namespace internal {
+
+
+// Hands out storage aligned to `Alignment` bytes (a cache line by default), e.g. for `std::vector<T, aligned_allocator<T>>`.
+template<class T, std::size_t Alignment = 64>
+struct aligned_allocator {
+    using value_type = T;
+
+    static constexpr std::align_val_t ALIGNMENT{ std::max(Alignment, alignof(T)) };
+
+    template<class U>
+    struct rebind { using other = aligned_allocator<U, Alignment>; };
+
+    aligned_allocator() noexcept = default;
+
+    template<class U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&) noexcept {}
+
+    inline T* allocate(const std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), ALIGNMENT));
+    }
+
+    inline void deallocate(T *const ptr, const std::size_t n) noexcept {
+        ::operator delete(ptr, n * sizeof(T), ALIGNMENT);
+    }
+
+    template<class U>
+    friend inline bool operator==(const aligned_allocator&, const aligned_allocator<U, Alignment>&) noexcept { return true; }
+};
+
+
+} // namespace internal
+
+} // namespace uni
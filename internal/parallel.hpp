@@ -0,0 +1,73 @@
+#pragma once
+
+
+#include <algorithm>
+#include <vector>
+#include <thread>
+#include <bit>
+
+
+#include "snippet/iterations.hpp"
+
+#include "internal/dev_env.hpp"
+#include "internal/types.hpp"
+
+#include "numeric/arithmetic.hpp"
+
+
+namespace uni {
+
+
+// Opts a build into `threads` workers, e.g. `tree.assign(uni::parallel{}, data)`.
+// Every value is computed by the same expression as in the sequential build, so that the result does not depend on the split.
+struct parallel {
+    internal::size_t threads = std::max<internal::size_t>(1, std::thread::hardware_concurrency());
+};
+
+
+namespace internal {
+
+
+// Below this many items per worker, spawning the worker costs more than it saves.
+inline constexpr internal::size_t PARALLEL_GRAIN = 1 << 15;
+
+
+// Calls `f(begin, end)` on contiguous chunks of `[first, last)`, one per worker; the calling thread takes the first chunk.
+template<class F>
+void parallel_for(const parallel& policy, const internal::size_t first, const internal::size_t last, F&& f, const internal::size_t grain = PARALLEL_GRAIN) noexcept(NO_EXCEPT) {
+    const internal::size_t size = last - first;
+    const internal::size_t workers = std::clamp<internal::size_t>(size / std::max<internal::size_t>(grain, 1), 1, std::max<internal::size_t>(policy.threads, 1));
+
+    if(workers <= 1) {
+        if(size > 0) f(first, last);
+        return;
+    }
+
+    std::vector<std::thread> threads;
+    threads.reserve(workers - 1);
+
+    FOR(i, 1, workers - 1) {
+        threads.emplace_back([&f, first, size, workers, i] { f(first + size * i / workers, first + size * (i + 1) / workers); });
+    }
+    f(first, first + size / workers);
+
+    for(auto& thread : threads) thread.join();
+}
+
+
+// Calls `pull(p)` on every node `p` of `[1, end)` of an implicit binary tree, the children before their parent.
+// The nodes of a level are independent, and shared among the workers.
+template<class F>
+void parallel_pull(const parallel& policy, const internal::size_t end, F&& pull) noexcept(NO_EXCEPT) {
+    if(end <= 1) return;
+
+    REPD(level, static_cast<internal::size_t>(std::bit_width(uni::to_unsigned(end - 1)))) {
+        const internal::size_t lo = internal::size_t{ 1 } << level, hi = std::min(lo << 1, end);
+        parallel_for(policy, lo, hi, [&pull](const internal::size_t first, const internal::size_t last) { REPD(p, first, last) pull(p); });
+    }
+}
+
+
+} // namespace internal
+
+} // namespace uni
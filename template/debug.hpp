@@ -15,17 +15,63 @@
 #ifdef DEBUGGER_ENABLED
 
 
-#define debug(...) debugger::debug(debugger::split(#__VA_ARGS__), 0, __LINE__, __FILE__, __VA_ARGS__)
-#define debug_(...) do { const std::string file = __FILE__; debugger::raw(nullptr, debugger::COLOR_LINE + file.substr(file.find_last_of("/") + 1) + " #" + std::to_string(__LINE__) + debugger::COLOR_INIT + "  "); debugger::raw(__VA_ARGS__); debugger::raw(nullptr, debugger::COLOR_INIT + "\n"); } while(0);
+#include "debugger/profiler.hpp"
+#include "debugger/memory.hpp"
+
+
+#define DEBUGGER_DEBUG(id, sampler, names, ...) ( \
+    debugger::site<id>(sampler) ? \
+        (debugger::debug)(debugger::site<id>, debugger::split<debugger::count_arguments(names)>(names), 0, __LINE__, __FILE__, __VA_ARGS__) : \
+        void() \
+)
+
+#define debug(...) DEBUGGER_DEBUG(__COUNTER__, debugger::sampling::always{}, #__VA_ARGS__, __VA_ARGS__)
+#define debug_every(n, ...) DEBUGGER_DEBUG(__COUNTER__, debugger::sampling::every{ n }, #__VA_ARGS__, __VA_ARGS__)
+#define debug_first(k, ...) DEBUGGER_DEBUG(__COUNTER__, debugger::sampling::first{ k }, #__VA_ARGS__, __VA_ARGS__)
+#define debug_rate(m, ...) DEBUGGER_DEBUG(__COUNTER__, debugger::sampling::rate{ m }, #__VA_ARGS__, __VA_ARGS__)
+
+#define DEBUGGER_DEBUG_DIFF(id, names, ...) ( \
+    debugger::site<id>(debugger::sampling::always{}), \
+    (debugger::debug_diff<id>)(debugger::site<id>, debugger::split<debugger::count_arguments(names)>(names), __LINE__, __FILE__, __VA_ARGS__) \
+)
+
+#define debug_diff(...) DEBUGGER_DEBUG_DIFF(__COUNTER__, #__VA_ARGS__, __VA_ARGS__)
+
+#define DEBUGGER_DEBUG_MEMORY(id, names, ...) ( \
+    debugger::site<id>(debugger::sampling::always{}), \
+    (debugger::debug_memory)(debugger::site<id>, debugger::split<debugger::count_arguments(names)>(names), __LINE__, __FILE__, __VA_ARGS__) \
+)
+
+#define debug_memory(...) DEBUGGER_DEBUG_MEMORY(__COUNTER__, #__VA_ARGS__, __VA_ARGS__)
+#define debug_(...) do { const std::string file = __FILE__; debugger::raw(nullptr, debugger::COLOR_LINE + file.substr(file.find_last_of("/") + 1) + " #" + std::to_string(__LINE__) + debugger::COLOR_INIT + "  "); debugger::raw(__VA_ARGS__); debugger::raw(nullptr, debugger::COLOR_INIT + "\n"); debugger::flush_buffer(); } while(0);
 #define DEBUG if constexpr(true)
 
+#define DEBUGGER_CONCAT_IMPL(x, y) x##y
+#define DEBUGGER_CONCAT(x, y) DEBUGGER_CONCAT_IMPL(x, y)
+
+// Times the rest of the enclosing scope; the statistics are printed at exit.
+#define DEBUGGER_PROFILE(id, name) \
+    static debugger::profiler::entry& DEBUGGER_CONCAT(debugger_profile_entry_, id) = debugger::profiler::entries.enroll(name, __FILE__, __LINE__); \
+    const debugger::profiler::scope DEBUGGER_CONCAT(debugger_profile_scope_, id){ DEBUGGER_CONCAT(debugger_profile_entry_, id) }
+
+#define profile(name) DEBUGGER_PROFILE(__COUNTER__, name)
+#define profile_function() DEBUGGER_PROFILE(__COUNTER__, __func__)
+
 
 #else
 
 
 #define debug(...) ({ ; })
+#define debug_every(...) ({ ; })
+#define debug_first(...) ({ ; })
+#define debug_rate(...) ({ ; })
+#define debug_diff(...) ({ ; })
+#define debug_memory(...) ({ ; })
 #define debug_(...) ({ ; })
 #define DEBUG if constexpr(false)
 
+#define profile(...) ({ ; })
+#define profile_function() ({ ; })
+
 
 #endif
@@ -0,0 +1,30 @@
+/*
+ * @uni_kakurenbo
+ * https://github.com/uni-kakurenbo/competitive-programming-workspace
+ *
+ * CC0 1.0  http://creativecommons.org/publicdomain/zero/1.0/deed.ja
+ */
+/* #language C++ GCC */
+
+#define PROBLEM "https://judge.u-aizu.ac.jp/onlinejudge/description.jsp?id=CGL_1_A"
+#define ERROR 1e-8
+
+#include "snippet/fast_io.hpp"
+#include "snippet/aliases.hpp"
+#include "snippet/iterations.hpp"
+#include "adaptor/io.hpp"
+#include "geometry/point.hpp"
+#include "geometry/line.hpp"
+
+using point = uni::point<uni::ld>;
+
+signed main() {
+    print << std::scientific << std::setprecision(12);
+
+    uni::line<point> line; input >> line;
+    uni::i32 q; input >> q;
+    REP(q) {
+        point p; input >> p;
+        print(line.projection(p));
+    }
+}
@@ -0,0 +1,27 @@
+/*
+ * @uni_kakurenbo
+ * https://github.com/uni-kakurenbo/competitive-programming-workspace
+ *
+ * CC0 1.0  http://creativecommons.org/publicdomain/zero/1.0/deed.ja
+ */
+/* #language C++ 20 GCC */
+
+#define PROBLEM "https://judge.u-aizu.ac.jp/onlinejudge/description.jsp?id=ITP1_8_A"
+
+#include <cctype>
+#include <string>
+#include <string_view>
+#include "snippet/aliases.hpp"
+#include "adaptor/io.hpp"
+
+signed main() {
+    std::string_view line; uni::fast_reader::standard().getline(line);
+
+    std::string res(line);
+    for(auto& c : res) {
+        if(std::islower(c)) c = static_cast<char>(std::toupper(c));
+        else if(std::isupper(c)) c = static_cast<char>(std::tolower(c));
+    }
+
+    print(res);
+}
@@ -0,0 +1,25 @@
+/*
+ * @uni_kakurenbo
+ * https://github.com/uni-kakurenbo/competitive-programming-workspace
+ *
+ * CC0 1.0  http://creativecommons.org/publicdomain/zero/1.0/deed.ja
+ */
+/* #language C++ GCC */
+
+#define PROBLEM "https://judge.yosupo.jp/problem/many_aplusb"
+
+#include <iostream>
+#include "snippet/aliases.hpp"
+#include "snippet/fast_io.hpp"
+#include "snippet/iterations.hpp"
+#include "adaptor/io.hpp"
+
+signed main() {
+    uni::output_adaptor<uni::fast_writer, uni::newline_separator, uni::space_separator> out;
+
+    uni::i32 t; input >> t;
+    REP(t) {
+        uni::i64 a, b; input >> a >> b;
+        out(a + b);
+    }
+}
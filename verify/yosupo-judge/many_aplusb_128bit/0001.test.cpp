@@ -0,0 +1,26 @@
+/*
+ * @uni_kakurenbo
+ * https://github.com/uni-kakurenbo/competitive-programming-workspace
+ *
+ * CC0 1.0  http://creativecommons.org/publicdomain/zero/1.0/deed.ja
+ */
+/* #language C++ GCC */
+
+#define PROBLEM "https://judge.yosupo.jp/problem/many_aplusb_128bit"
+
+#include <iostream>
+#include "snippet/aliases.hpp"
+#include "snippet/iterations.hpp"
+#include "adaptor/io.hpp"
+#include "numeric/int128.hpp"
+
+signed main() {
+    uni::input_adaptor<uni::fast_reader> in;
+    uni::output_adaptor<uni::fast_writer> out;
+
+    uni::i32 t; in >> t;
+    REP(t) {
+        uni::i128 a, b; in >> a >> b;
+        out(a + b);
+    }
+}
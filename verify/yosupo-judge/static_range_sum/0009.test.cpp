@@ -0,0 +1,31 @@
+/*
+ * @uni_kakurenbo
+ * https://github.com/uni-kakurenbo/competitive-programming-workspace
+ *
+ * CC0 1.0  http://creativecommons.org/publicdomain/zero/1.0/deed.ja
+ */
+/* #language C++ GCC */
+
+#define PROBLEM "https://judge.yosupo.jp/problem/static_range_sum"
+
+#include <iostream>
+#include "snippet/aliases.hpp"
+#include "snippet/fast_io.hpp"
+#include "snippet/iterations.hpp"
+#include "adaptor/io.hpp"
+#include "adaptor/vector.hpp"
+#include "data_structure/fenwick_tree.hpp"
+#include "algebraic/addition.hpp"
+
+signed main() {
+    uni::i32 n, q; input >> n >> q;
+    uni::vector<uni::i64> a(n); input >> a;
+    uni::fenwick_tree<uni::algebraic::addition<uni::i64>> sum(a);
+
+    uni::vector<uni::spair<uni::i32>> queries(q); input >> queries;
+    uni::vector<uni::algebraic::addition<uni::i64>> res(q);
+
+    sum.fold(queries, res.begin());
+
+    ITR(v, res) print(v);
+}
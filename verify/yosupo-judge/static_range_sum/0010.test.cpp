@@ -0,0 +1,29 @@
+/*
+ * @uni_kakurenbo
+ * https://github.com/uni-kakurenbo/competitive-programming-workspace
+ *
+ * CC0 1.0  http://creativecommons.org/publicdomain/zero/1.0/deed.ja
+ */
+/* #language C++ GCC */
+
+#define PROBLEM "https://judge.yosupo.jp/problem/static_range_sum"
+
+#include <iostream>
+#include <vector>
+#include "snippet/aliases.hpp"
+#include "snippet/fast_io.hpp"
+#include "snippet/iterations.hpp"
+#include "adaptor/io.hpp"
+#include "iterable/accumulation.hpp"
+
+signed main() {
+    uni::input_adaptor<uni::fast_reader> in;
+
+    uni::i32 n, q; in >> n >> q;
+    std::vector<uni::i32> a(n); in >> a;
+    uni::accumulation<uni::ll> sum(ALL(a));
+
+    std::vector<uni::i32> queries(2 * q); in >> queries;
+
+    REP(i, q) print(sum(queries[2 * i], queries[2 * i + 1]));
+}
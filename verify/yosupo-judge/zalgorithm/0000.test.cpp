@@ -0,0 +1,23 @@
+/*
+ * @uni_kakurenbo
+ * https://github.com/uni-kakurenbo/competitive-programming-workspace
+ *
+ * CC0 1.0  http://creativecommons.org/publicdomain/zero/1.0/deed.ja
+ */
+/* #language C++ GCC */
+
+#define PROBLEM "https://judge.yosupo.jp/problem/zalgorithm"
+
+#include <iostream>
+#include <string_view>
+#include "snippet/aliases.hpp"
+#include "snippet/fast_io.hpp"
+#include "adaptor/io.hpp"
+#include "iterable/z_array.hpp"
+
+signed main() {
+    uni::input_adaptor<uni::fast_reader> in;
+
+    std::string_view s; in >> s;
+    print(uni::z_array(s));
+}